@@ -0,0 +1,215 @@
+#pragma once
+
+// Minimal self-contained benchmark harness: each benchmark is a body that runs
+// a requested number of iterations; the harness calibrates the count to a
+// minimum run time, repeats, and reports median/min ns per iteration as a
+// table, CSV or JSON.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bench {
+
+// Keeps the compiler from discarding a computed value
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct Result {
+    std::string name;
+    size_t iterations{0};  // per repetition
+    size_t repetitions{0};
+    double medianNs{0.0};  // per iteration
+    double minNs{0.0};
+    double maxNs{0.0};
+    double itemsPerSecond{0.0}; // from the median; items = iterations x batch size
+};
+
+class Suite {
+public:
+    using Body = std::function<void(size_t iterations)>;
+
+    // itemsPerIteration scales items_per_second for bodies whose iteration
+    // processes a whole batch (e.g. a basket of orders)
+    void add(std::string name, Body body, size_t itemsPerIteration = 1) {
+        cases_.push_back({std::move(name), std::move(body), itemsPerIteration});
+    }
+
+    int main(int argc, char** argv) {
+        std::string format = "table";
+        std::string output;
+        std::string filter;
+        double minTime = 0.2;
+        size_t repetitions = 5;
+
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto value = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument("missing value for " + arg);
+                }
+                return argv[++i];
+            };
+            if (arg == "--format") {
+                format = value();
+            } else if (arg == "--out") {
+                output = value();
+            } else if (arg == "--filter") {
+                filter = value();
+            } else if (arg == "--min-time") {
+                minTime = std::stod(value());
+            } else if (arg == "--repetitions") {
+                repetitions = std::max<size_t>(1, std::stoul(value()));
+            } else if (arg == "--list") {
+                for (const auto& c : cases_) {
+                    std::cout << c.name << "\n";
+                }
+                return 0;
+            } else {
+                std::cerr << "usage: " << argv[0]
+                          << " [--format table|csv|json] [--out FILE] [--filter SUBSTRING]"
+                             " [--min-time SECONDS] [--repetitions N] [--list]" << std::endl;
+                return arg == "--help" ? 0 : 2;
+            }
+        }
+        if (format != "table" && format != "csv" && format != "json") {
+            std::cerr << "unknown format: " << format << std::endl;
+            return 2;
+        }
+
+        std::vector<Result> results;
+        for (const auto& c : cases_) {
+            if (!filter.empty() && c.name.find(filter) == std::string::npos) {
+                continue;
+            }
+            results.push_back(run_(c, minTime, repetitions));
+            std::cerr << "  " << c.name << " done" << std::endl;
+        }
+
+        std::ostringstream text;
+        if (format == "json") {
+            writeJson_(text, results);
+        } else if (format == "csv") {
+            writeCsv_(text, results);
+        } else {
+            writeTable_(text, results);
+        }
+
+        if (output.empty()) {
+            std::cout << text.str();
+        } else {
+            std::ofstream file(output);
+            if (!file) {
+                std::cerr << "cannot write " << output << std::endl;
+                return 1;
+            }
+            file << text.str();
+        }
+        return 0;
+    }
+
+private:
+    struct Case {
+        std::string name;
+        Body body;
+        size_t itemsPerIteration;
+    };
+
+    static double timeOnce_(const Case& c, size_t iterations) {
+        auto start = std::chrono::steady_clock::now();
+        c.body(iterations);
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    static Result run_(const Case& c, double minTime, size_t repetitions) {
+        // Grow the iteration count until one run takes a tenth of minTime,
+        // then scale it to minTime
+        size_t iterations = 1;
+        double elapsed = timeOnce_(c, iterations);
+        while (elapsed < minTime / 10 && iterations < (size_t{1} << 40)) {
+            iterations *= 10;
+            elapsed = timeOnce_(c, iterations);
+        }
+        if (elapsed < minTime) {
+            iterations = static_cast<size_t>(static_cast<double>(iterations) * minTime / std::max(elapsed, 1e-9));
+        }
+        iterations = std::max<size_t>(iterations, 1);
+
+        std::vector<double> perIteration;
+        for (size_t r = 0; r < repetitions; ++r) {
+            perIteration.push_back(timeOnce_(c, iterations) * 1e9 / static_cast<double>(iterations));
+        }
+        std::sort(perIteration.begin(), perIteration.end());
+
+        Result result;
+        result.name = c.name;
+        result.iterations = iterations;
+        result.repetitions = repetitions;
+        result.medianNs = perIteration[perIteration.size() / 2];
+        result.minNs = perIteration.front();
+        result.maxNs = perIteration.back();
+        result.itemsPerSecond = static_cast<double>(c.itemsPerIteration) * 1e9 / result.medianNs;
+        return result;
+    }
+
+    static std::string timestamp_() {
+        std::time_t now = std::time(nullptr);
+        std::tm utc{};
+        gmtime_r(&now, &utc);
+        char buffer[32];
+        std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &utc);
+        return buffer;
+    }
+
+    static void writeJson_(std::ostream& out, const std::vector<Result>& results) {
+        out << std::setprecision(6);
+        out << "{\n  \"context\": {\"date\": \"" << timestamp_() << "\", \"hardware_threads\": "
+            << std::thread::hardware_concurrency() << "},\n  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            out << "    {\"name\": \"" << r.name << "\", \"iterations\": " << r.iterations
+                << ", \"repetitions\": " << r.repetitions << ", \"median_ns\": " << r.medianNs
+                << ", \"min_ns\": " << r.minNs << ", \"max_ns\": " << r.maxNs
+                << ", \"items_per_second\": " << r.itemsPerSecond << "}"
+                << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+    }
+
+    static void writeCsv_(std::ostream& out, const std::vector<Result>& results) {
+        out << std::setprecision(6);
+        out << "name,iterations,repetitions,median_ns,min_ns,max_ns,items_per_second\n";
+        for (const Result& r : results) {
+            out << r.name << "," << r.iterations << "," << r.repetitions << "," << r.medianNs << ","
+                << r.minNs << "," << r.maxNs << "," << r.itemsPerSecond << "\n";
+        }
+    }
+
+    static void writeTable_(std::ostream& out, const std::vector<Result>& results) {
+        out << std::left << std::setw(48) << "benchmark" << std::right << std::setw(14) << "median ns"
+            << std::setw(14) << "min ns" << std::setw(16) << "items/sec" << std::setw(14) << "iterations" << "\n";
+        out << std::fixed;
+        for (const Result& r : results) {
+            out << std::left << std::setw(48) << r.name << std::right << std::setprecision(1)
+                << std::setw(14) << r.medianNs << std::setw(14) << r.minNs << std::setprecision(0)
+                << std::setw(16) << r.itemsPerSecond << std::setw(14) << r.iterations << "\n";
+        }
+    }
+
+    std::vector<Case> cases_;
+};
+
+} // namespace bench
@@ -0,0 +1,131 @@
+// Reaction latency of timer-driven against market-data-driven chunk release,
+// on the real clock. One order per symbol; each symbol's book is dry (no
+// quoted size) until liquidity shows up at a random moment, and dries up
+// again once the order has traded. Latency runs to the fill from the tick
+// that showed liquidity or, if later, the start of the chunk's slot of the
+// horizon, before which neither trigger may trade it.
+//
+// usage: chunk_trigger_benchmark [symbols] [seconds]
+#include "trading_engine.hpp"
+#include "async_logger.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct Result {
+    LatencySummary latency;
+    uint64_t released{0};
+    uint64_t fills{0};
+};
+
+Result run(ChunkTrigger trigger, int symbols, int seconds) {
+    EngineConfig config;
+    config.chunkTrigger = trigger;
+    config.releaseWindow = 1.0;       // a chunk may fire as soon as its slot of the horizon begins
+    config.dispatcher.async = false;  // callbacks on the filling thread, so fill times are exact
+    TradingEngine engine(config);
+
+    std::vector<SymbolId> ids(symbols);
+    std::vector<std::atomic<int64_t>> filledAt(symbols);
+    std::vector<std::atomic<int>> chunksFilled(symbols);
+    std::vector<TradingEngine::Order> orders;
+    for (int s = 0; s < symbols; ++s) {
+        std::string symbol = "SYM" + std::to_string(s);
+        ids[s] = engine.internSymbol(symbol);
+        orders.push_back({symbol, 100000, s % 2 == 0, 100.0, static_cast<double>(seconds), 1.0, "", 10});
+    }
+    std::atomic<uint64_t> fills{0};
+    engine.setExecutionCallback([&](const std::string&, const std::string& symbol, double, double, double, double) {
+        int s = std::stoi(symbol.substr(3));
+        chunksFilled[s].fetch_add(1, std::memory_order_relaxed);
+        filledAt[s].store(nowNs(), std::memory_order_release);
+        fills.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    MarketQuote dry{99.99, 100.01, 100.0, 0.0, 0, 0, 0};
+    MarketQuote liquid{99.99, 100.01, 100.0, 0.0, 0, 50000, 50000};
+    for (SymbolId id : ids) {
+        engine.onMarketDataUpdate(id, dry);
+    }
+    auto handles = engine.submitOrders(orders);
+    const int64_t started = nowNs();
+    const int64_t interval = int64_t{seconds} * 1'000'000'000 / 10;
+    engine.startExecutions(handles);
+
+    // Feed: a dry symbol turns liquid after 0-100 ms; a liquid one goes dry
+    // once a fill lands after the tick that showed the liquidity
+    latency_histogram latency;
+    std::mt19937_64 rng(7);
+    std::vector<int64_t> liquidAt(symbols, 0);
+    std::vector<int64_t> showAt(symbols);
+    int64_t start = nowNs();
+    for (int s = 0; s < symbols; ++s) {
+        showAt[s] = start + static_cast<int64_t>(rng() % 100'000'000);
+    }
+    int64_t end = start + int64_t{seconds} * 1'000'000'000;
+    while (nowNs() < end) {
+        for (int s = 0; s < symbols; ++s) {
+            int64_t now = nowNs();
+            if (liquidAt[s] == 0 && now >= showAt[s]) {
+                liquidAt[s] = now;
+                engine.onMarketDataUpdate(ids[s], liquid);
+            } else if (liquidAt[s] != 0) {
+                int64_t filled = filledAt[s].load(std::memory_order_acquire);
+                if (filled > liquidAt[s]) {
+                    int chunk = chunksFilled[s].load(std::memory_order_relaxed) - 1;
+                    int64_t from = std::max(liquidAt[s], started + chunk * interval);
+                    latency.record(static_cast<uint64_t>(std::max<int64_t>(filled - from, 0)));
+                    liquidAt[s] = 0;
+                    showAt[s] = now + static_cast<int64_t>(rng() % 100'000'000);
+                    engine.onMarketDataUpdate(ids[s], dry);
+                }
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+
+    Result result;
+    result.latency = latency.summary();
+    result.released = engine.stats().releasedChunks;
+    result.fills = fills.load();
+    engine.shutdown();
+    return result;
+}
+
+void report(const char* label, const Result& result) {
+    std::cout << std::left << std::setw(12) << label << std::right << std::fixed << std::setprecision(1)
+              << std::setw(8) << result.latency.count << " reactions"
+              << std::setw(12) << result.latency.p50 / 1e3 << " us p50"
+              << std::setw(12) << result.latency.p99 / 1e3 << " us p99"
+              << std::setw(12) << result.latency.mean / 1e3 << " us mean"
+              << std::setw(8) << result.fills << " fills"
+              << std::setw(8) << result.released << " released early" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int symbols = argc > 1 ? std::atoi(argv[1]) : 64;
+    int seconds = argc > 2 ? std::atoi(argv[2]) : 5;
+    async_logger::instance().setLevel(LogLevel::Warn);
+
+    std::cout << "symbols=" << symbols << " seconds=" << seconds << " (chunk interval "
+              << seconds * 100 << " ms)" << std::endl;
+    report("timer", run(ChunkTrigger::Timer, symbols, seconds));
+    report("marketdata", run(ChunkTrigger::MarketData, symbols, seconds));
+    return 0;
+}
@@ -0,0 +1,113 @@
+// Cost of journaling on the order path and time to rebuild the engine from
+// the journal after a restart. A simulated-clock engine submits and starts a
+// basket and runs it halfway; a second engine then recovers from the journal
+// alone, and a third from a checkpoint plus the journal written after it.
+//
+// usage: journal_recovery_benchmark [orders] [symbols] [directory]
+#include "trading_engine.hpp"
+#include "async_logger.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<TradingEngine::Order> makeBasket(int orders, int symbols) {
+    std::vector<TradingEngine::Order> basket;
+    basket.reserve(orders);
+    for (int i = 0; i < orders; ++i) {
+        TradingEngine::Order order;
+        order.symbol = "SYM" + std::to_string(i % symbols);
+        order.totalShares = 1000 + 37 * (i % 500);
+        order.isBuy = i % 2 == 0;
+        order.initialPrice = 20.0 + (i % 300);
+        order.timeHorizon = 600.0;
+        order.riskAversion = 1.0;
+        order.numIntervals = 20;
+        basket.push_back(order);
+    }
+    return basket;
+}
+
+EngineConfig simulatedConfig(const std::string& directory) {
+    EngineConfig config;
+    config.scheduler.clock = std::make_shared<simulated_clock>();
+    config.modelSeed = 1;
+    config.journal.directory = directory;
+    config.journal.snapshotInterval = std::chrono::seconds(0); // checkpoints are explicit here
+    return config;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Submit, start and run half the horizon (10 of 20 chunks per order)
+double runHalfway(TradingEngine& engine, const std::vector<TradingEngine::Order>& basket) {
+    auto start = std::chrono::steady_clock::now();
+    engine.startExecutions(engine.submitOrders(basket));
+    engine.runSimulationUntil(engine.now() + std::chrono::seconds(299));
+    return secondsSince(start);
+}
+
+void report(const char* label, double seconds, const RecoveryStats& recovery) {
+    std::cerr << std::left << std::setw(22) << label << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << seconds * 1e3 << " ms" << std::setw(10) << recovery.orders << " orders"
+              << std::setw(10) << recovery.replay.snapshotRecords << " snap"
+              << std::setw(10) << recovery.replay.segmentRecords << " journal"
+              << std::setw(8) << static_cast<double>(recovery.replay.bytes) / (1 << 20) << " MiB"
+              << std::setw(12) << std::setprecision(0) << recovery.orders / seconds << " orders/s" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int orders = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int symbols = argc > 2 ? std::atoi(argv[2]) : 500;
+    std::string directory = argc > 3 ? argv[3]
+        : (std::filesystem::temp_directory_path() / "ac_journal_benchmark").string();
+    async_logger::instance().setLevel(LogLevel::Warn);
+    std::filesystem::remove_all(directory);
+
+    auto basket = makeBasket(orders, symbols);
+
+    double plain = 0.0;
+    {
+        EngineConfig config = simulatedConfig("");
+        TradingEngine engine(config);
+        plain = runHalfway(engine, basket);
+    }
+    double journaled = 0.0;
+    JournalStats journal;
+    {
+        TradingEngine engine(simulatedConfig(directory));
+        journaled = runHalfway(engine, basket);
+        journal = engine.stats().journal;
+    }
+
+    std::cerr << "orders=" << orders << " symbols=" << symbols << " directory=" << directory << std::endl;
+    std::cerr << std::fixed << std::setprecision(1) << "submit + half the fills: " << plain * 1e3
+              << " ms without journal, " << journaled * 1e3 << " ms with (" << journal.records << " records, "
+              << static_cast<double>(journal.bytes) / (1 << 20) << " MiB, " << journal.commits << " group commits)"
+              << std::endl;
+
+    {
+        auto start = std::chrono::steady_clock::now();
+        TradingEngine engine(simulatedConfig(directory));
+        report("journal only", secondsSince(start), engine.stats().recovery);
+        engine.checkpoint();
+        engine.runSimulationUntil(engine.now() + std::chrono::seconds(60)); // some journal after the snapshot
+    }
+    {
+        auto start = std::chrono::steady_clock::now();
+        TradingEngine engine(simulatedConfig(directory));
+        report("snapshot + journal", secondsSince(start), engine.stats().recovery);
+    }
+
+    std::filesystem::remove_all(directory);
+    return 0;
+}
@@ -0,0 +1,355 @@
+// Regression suite for the model, scheduler and engine hot paths. Everything
+// runs in-process on simulated time, so results depend only on the machine.
+//
+// usage: micro_benchmarks [--format table|csv|json] [--out FILE] [--filter SUBSTRING]
+//                         [--min-time SECONDS] [--repetitions N] [--list]
+#include "bench_harness.hpp"
+#include "async_logger.hpp"
+#include "execution_scheduler.hpp"
+#include "market_impact_model.hpp"
+#include "monte_carlo_simulator.hpp"
+#include "philox_rng.hpp"
+#include "portfolio_model.hpp"
+#include "schedule_cache.hpp"
+#include "simulated_book.hpp"
+#include "trajectory_kernel.hpp"
+#include "trading_engine.hpp"
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+AlmgrenChrissModel makeModel() {
+    AlmgrenChrissModel model;
+    model.setParameters(0.0020, 1.0e-11, 1.0e-04, 1.0, 150.0, 50000.0, 600.0);
+    model.seed(7);
+    return model;
+}
+
+void addModelBenchmarks(bench::Suite& suite) {
+    suite.add("model/computeRemainingShares", [](size_t iterations) {
+        AlmgrenChrissModel model = makeModel();
+        double step = model.getTimeHorizon() / 1024.0;
+        double acc = 0.0;
+        for (size_t i = 0; i < iterations; ++i) {
+            acc += model.computeRemainingShares(static_cast<double>(i & 1023) * step);
+        }
+        bench::doNotOptimize(acc);
+    });
+
+    suite.add("model/computeTradingRate", [](size_t iterations) {
+        AlmgrenChrissModel model = makeModel();
+        double step = model.getTimeHorizon() / 1024.0;
+        double acc = 0.0;
+        for (size_t i = 0; i < iterations; ++i) {
+            acc += model.computeTradingRate(static_cast<double>(i & 1023) * step);
+        }
+        bench::doNotOptimize(acc);
+    });
+
+    for (int intervals : {10, 50, 100, 1000}) {
+        suite.add("model/calculateOptimalSchedule/" + std::to_string(intervals), [intervals](size_t iterations) {
+            AlmgrenChrissModel model = makeModel();
+            for (size_t i = 0; i < iterations; ++i) {
+                auto schedule = model.calculateOptimalSchedule(intervals);
+                bench::doNotOptimize(schedule.data());
+            }
+        });
+    }
+
+    suite.add("model/fixedScheduleShape/10", [](size_t iterations) {
+        AlmgrenChrissModel model = makeModel();
+        for (size_t i = 0; i < iterations; ++i) {
+            auto shape = model.fixedScheduleShape<10>();
+            bench::doNotOptimize(shape);
+        }
+    });
+
+    suite.add("model/fixedScheduleShape/100", [](size_t iterations) {
+        AlmgrenChrissModel model = makeModel();
+        for (size_t i = 0; i < iterations; ++i) {
+            auto shape = model.fixedScheduleShape<100>();
+            bench::doNotOptimize(shape);
+        }
+    });
+
+    // One point per iteration, evaluated over a 1024-point trajectory
+    suite.add("model/computeRemainingShares/batch1024", [](size_t iterations) {
+        AlmgrenChrissModel model = makeModel();
+        std::vector<double> times(1024);
+        std::vector<double> out(times.size());
+        for (size_t i = 0; i < times.size(); ++i) {
+            times[i] = static_cast<double>(i) * model.getTimeHorizon() / 1024.0;
+        }
+        for (size_t done = 0; done < iterations; done += times.size()) {
+            model.computeRemainingShares(times, out);
+            bench::doNotOptimize(out.data());
+        }
+    });
+
+    // One iteration = 1000 orders x 100 intervals, kappas spread over 0.1..10
+    suite.add("model/scheduleBatch/1000x100", [](size_t iterations) {
+        trajectory::TrajectoryBatch batch;
+        for (int i = 0; i < 1000; ++i) {
+            batch.add(0.1 / 600.0 * (1.0 + i * 0.1), 600.0, 1000.0 + i);
+        }
+        std::vector<double> out(batch.size() * 100);
+        for (size_t i = 0; i < iterations; ++i) {
+            trajectory::scheduleBatch(batch, 100, out.data());
+            bench::doNotOptimize(out.data());
+        }
+    }, 1000);
+
+    // Hit path: one shard lookup plus scaling the shared shape
+    for (int intervals : {10, 100}) {
+        suite.add("model/scheduleCacheHit/" + std::to_string(intervals), [intervals](size_t iterations) {
+            AlmgrenChrissModel model = makeModel();
+            schedule_cache cache;
+            ScheduleKey key{model.getKappa(), model.getTimeHorizon(), intervals};
+            auto compute = [&] { return model.scheduleShape(intervals); };
+            for (size_t i = 0; i < iterations; ++i) {
+                auto schedule = cache.schedule(key, 1000.0 + static_cast<double>(i & 1023), compute);
+                bench::doNotOptimize(schedule.data());
+            }
+        });
+    }
+
+    suite.add("model/simulatePriceStep", [](size_t iterations) {
+        AlmgrenChrissModel model = makeModel();
+        double acc = 0.0;
+        for (size_t i = 0; i < iterations; ++i) {
+            if (model.getElapsedTime() >= model.getTimeHorizon()) {
+                model.reset();
+            }
+            acc += model.simulatePriceStep(0.01);
+        }
+        bench::doNotOptimize(acc);
+    });
+    // One iteration = one normal, drawn in batches of 1024
+    suite.add("model/fillNormal/1024", [](size_t iterations) {
+        philox_rng rng(7);
+        std::vector<double> normals(1024);
+        for (size_t done = 0; done < iterations; done += normals.size()) {
+            rng.fillNormal(normals);
+            bench::doNotOptimize(normals.data());
+        }
+    });
+    // One iteration = one 10-step path
+    suite.add("model/monteCarlo/10", [](size_t iterations) {
+        AlmgrenChrissModel model = makeModel();
+        std::vector<double> schedule = model.calculateOptimalSchedule(10);
+        MonteCarloResult result = MonteCarloSimulator(1).run(model, schedule, iterations, true, 7);
+        bench::doNotOptimize(result.mean);
+    });
+}
+
+// Basket inputs shaped like a risk model: a few factors plus specific risk
+// for covariance, and impact with a small cross-asset term so the
+// Cholesky path runs
+struct BasketInputs {
+    std::vector<double> covariance;
+    std::vector<double> impact;
+    std::vector<double> positions;
+};
+
+BasketInputs makeBasket(size_t assets) {
+    constexpr size_t kFactors = 8;
+    std::mt19937_64 rng(11);
+    std::normal_distribution<double> normal;
+    std::vector<double> loadings(assets * kFactors);
+    for (double& loading : loadings) {
+        loading = 0.001 * normal(rng);
+    }
+    BasketInputs inputs{std::vector<double>(assets * assets), std::vector<double>(assets * assets),
+                        std::vector<double>(assets)};
+    for (size_t i = 0; i < assets; ++i) {
+        for (size_t j = 0; j < assets; ++j) {
+            double sum = i == j ? 4.0e-6 : 0.0;
+            for (size_t f = 0; f < kFactors; ++f) {
+                sum += loadings[i * kFactors + f] * loadings[j * kFactors + f];
+            }
+            inputs.covariance[i * assets + j] = sum;
+            inputs.impact[i * assets + j] = i == j ? 1.0e-4 : 2.0e-5 / static_cast<double>(assets);
+        }
+        inputs.positions[i] = (i % 3 == 0 ? -1.0 : 1.0) * (1000.0 + 100.0 * static_cast<double>(i % 17));
+    }
+    return inputs;
+}
+
+void addPortfolioBenchmarks(bench::Suite& suite) {
+    // Full O(n^3) path: Cholesky, two triangular solves, eigendecomposition
+    for (size_t assets : {100, 500}) {
+        suite.add("portfolio/setParameters/" + std::to_string(assets), [assets](size_t iterations) {
+            BasketInputs inputs = makeBasket(assets);
+            PortfolioLiquidationModel model;
+            for (size_t i = 0; i < iterations; ++i) {
+                model.setParameters(inputs.covariance, inputs.impact, 1.0, inputs.positions, 600.0);
+                bench::doNotOptimize(model.modeKappas().data());
+            }
+        });
+    }
+
+    // What a repeat basket costs once the decomposition is kept; the model is
+    // built on the first call only so calibration doesn't count it
+    suite.add("portfolio/setPositionsAndSchedule/500x20", [](size_t iterations) {
+        static BasketInputs inputs = makeBasket(500);
+        static PortfolioLiquidationModel model = [] {
+            PortfolioLiquidationModel built;
+            built.setParameters(inputs.covariance, inputs.impact, 1.0, inputs.positions, 600.0);
+            return built;
+        }();
+        for (size_t i = 0; i < iterations; ++i) {
+            inputs.positions[i % 500] += 1.0;
+            model.setPositions(inputs.positions);
+            auto schedule = model.calculateOptimalSchedule(20);
+            bench::doNotOptimize(schedule.data());
+        }
+    });
+}
+
+SchedulerConfig simulatedScheduler(SchedulerBackend backend) {
+    SchedulerConfig config;
+    config.backend = backend;
+    config.clock = std::make_shared<simulated_clock>();
+    return config;
+}
+
+void addSchedulerBenchmarks(bench::Suite& suite) {
+    const std::pair<const char*, SchedulerBackend> backends[] = {
+        {"heap", SchedulerBackend::BinaryHeap},
+        {"wheel", SchedulerBackend::TimingWheel},
+    };
+
+    for (const auto& [name, backend] : backends) {
+        // One iteration = one scheduleAt at a random deadline within a minute
+        suite.add(std::string("scheduler/insert/") + name, [backend](size_t iterations) {
+            execution_scheduler scheduler(simulatedScheduler(backend));
+            std::mt19937_64 rng(1);
+            auto base = scheduler.now();
+            for (size_t i = 0; i < iterations; ++i) {
+                scheduler.scheduleAt(base + std::chrono::microseconds(rng() % 60'000'000), [] {});
+            }
+        });
+
+        // One iteration = one task inserted and later dispatched by runUntilIdle
+        suite.add(std::string("scheduler/insert_dispatch/") + name, [backend](size_t iterations) {
+            execution_scheduler scheduler(simulatedScheduler(backend));
+            std::mt19937_64 rng(1);
+            size_t ran = 0;
+            auto base = scheduler.now();
+            for (size_t i = 0; i < iterations; ++i) {
+                scheduler.scheduleAt(base + std::chrono::microseconds(rng() % 60'000'000), [&ran] { ++ran; });
+            }
+            scheduler.runUntilIdle();
+            bench::doNotOptimize(ran);
+        });
+    }
+}
+
+void addBookBenchmarks(bench::Suite& suite) {
+    // One iteration = one child order of 100-355 shares walking a book, over
+    // 64 symbols whose quotes tick every 16 takes; 1 ms of simulated time
+    // passes per take, so depleted levels are part way back each time
+    for (size_t depth : {1, 10}) {
+        suite.add("book/take/" + std::to_string(depth), [depth](size_t iterations) {
+            constexpr SymbolId kSymbols = 64;
+            quote_board quotes(kSymbols);
+            MarketQuote quote{99.99, 100.01, 100.0, 0.0, 0, 200, 200};
+            for (SymbolId id = 0; id < kSymbols; ++id) {
+                quotes.publish(id, quote);
+            }
+            BookConfig config;
+            config.depth = depth;
+            simulated_book book(quotes, config);
+            double filled = 0.0;
+            int64_t nowNs = 0;
+            for (size_t i = 0; i < iterations; ++i) {
+                if ((i & 15) == 0) {
+                    quote.timestampNs = nowNs;
+                    quotes.publish(static_cast<SymbolId>((i >> 4) % kSymbols), quote);
+                }
+                nowNs += 1'000'000;
+                auto fill = book.take(static_cast<SymbolId>(i % kSymbols), (i & 1) != 0,
+                                      100.0 + static_cast<double>(i & 255), nowNs);
+                filled += fill->shares;
+            }
+            bench::doNotOptimize(filled);
+        });
+    }
+}
+
+void addEngineBenchmarks(bench::Suite& suite) {
+    // One iteration = a basket of orders submitted, started and run to
+    // completion (10 chunks each) on a fresh simulated-clock engine
+    for (size_t basket : {100, 1000}) {
+        suite.add("engine/submit_to_complete/" + std::to_string(basket), [basket](size_t iterations) {
+            std::vector<TradingEngine::Order> orders(basket);
+            for (size_t i = 0; i < basket; ++i) {
+                orders[i] = {"SYM" + std::to_string(i % 64), 10000, i % 2 == 0, 100.0, 60.0, 1.0, "", 10};
+            }
+            for (size_t it = 0; it < iterations; ++it) {
+                EngineConfig config;
+                config.scheduler.clock = std::make_shared<simulated_clock>();
+                config.modelSeed = 1;
+                TradingEngine engine(config);
+                engine.startExecutions(engine.submitOrders(orders));
+                engine.runSimulation();
+            }
+        }, basket);
+    }
+
+    // 100-leg basket on a warm engine: the decomposition is reused after the
+    // first submit, so this is the repeat-basket submit latency
+    suite.add("engine/submit_basket/100", [](size_t iterations) {
+        EngineConfig config;
+        config.scheduler.clock = std::make_shared<simulated_clock>();
+        TradingEngine engine(config);
+        BasketInputs inputs = makeBasket(100);
+        TradingEngine::BasketOrder basket;
+        for (size_t i = 0; i < 100; ++i) {
+            int shares = static_cast<int>(std::abs(inputs.positions[i]));
+            basket.legs.push_back({"SYM" + std::to_string(i), shares, inputs.positions[i] > 0.0, 100.0, 0.0, 0.0, "", 0});
+        }
+        basket.covariance = inputs.covariance;
+        basket.impact = inputs.impact;
+        basket.timeHorizon = 600.0;
+        basket.numIntervals = 20;
+        for (size_t i = 0; i < iterations; ++i) {
+            bench::doNotOptimize(engine.submitBasket(basket).data());
+        }
+    }, 100);
+
+    suite.add("engine/submit_single", [](size_t iterations) {
+        EngineConfig config;
+        config.scheduler.clock = std::make_shared<simulated_clock>();
+        TradingEngine engine(config);
+        TradingEngine::Order order{"SYM", 10000, true, 100.0, 60.0, 1.0, "", 10};
+        for (size_t i = 0; i < iterations; ++i) {
+            bench::doNotOptimize(engine.submitOrder(order));
+        }
+    });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // Keep engine log lines out of the measurements and out of stdout
+    async_logger::instance().setLevel(LogLevel::Warn);
+
+    bench::Suite suite;
+    addModelBenchmarks(suite);
+    addPortfolioBenchmarks(suite);
+    addSchedulerBenchmarks(suite);
+    addBookBenchmarks(suite);
+    addEngineBenchmarks(suite);
+
+    try {
+        return suite.main(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "error: " << e.what() << std::endl;
+        return 2;
+    }
+}
@@ -0,0 +1,108 @@
+// Orders/sec for a basket submitted one submitOrder() call at a time versus a
+// single submitOrders() call, plus the matching startExecution paths. Runs on
+// a simulated clock so no chunk ever fires during the measurement. The engine
+// logs to stdout; results go to stderr, so run with >/dev/null.
+//
+// usage: order_submission_benchmark [orders] [symbols] [rounds]
+#include "trading_engine.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<TradingEngine::Order> makeBasket(int orders, int symbols) {
+    std::vector<TradingEngine::Order> basket;
+    basket.reserve(orders);
+    for (int i = 0; i < orders; ++i) {
+        TradingEngine::Order order;
+        order.symbol = "SYM" + std::to_string(i % symbols);
+        order.totalShares = 1000 + 37 * (i % 500);
+        order.isBuy = i % 2 == 0;
+        order.initialPrice = 20.0 + (i % 300);
+        order.timeHorizon = 600.0;
+        order.riskAversion = 1.0;
+        order.numIntervals = 20;
+        basket.push_back(order);
+    }
+    return basket;
+}
+
+EngineConfig simulatedConfig() {
+    EngineConfig config;
+    config.scheduler.clock = std::make_shared<simulated_clock>();
+    return config;
+}
+
+struct Timing {
+    double submitSeconds;
+    double startSeconds;
+};
+
+Timing runSingle(const std::vector<TradingEngine::Order>& basket) {
+    TradingEngine engine(simulatedConfig());
+    std::vector<std::string> ids;
+    ids.reserve(basket.size());
+
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& order : basket) {
+        ids.push_back(engine.submitOrder(order));
+    }
+    auto submitted = std::chrono::steady_clock::now();
+    for (const auto& id : ids) {
+        engine.startExecution(id);
+    }
+    auto started = std::chrono::steady_clock::now();
+
+    return {std::chrono::duration<double>(submitted - start).count(),
+            std::chrono::duration<double>(started - submitted).count()};
+}
+
+Timing runBatch(const std::vector<TradingEngine::Order>& basket) {
+    TradingEngine engine(simulatedConfig());
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::string> ids = engine.submitOrders(basket);
+    auto submitted = std::chrono::steady_clock::now();
+    engine.startExecutions(ids);
+    auto started = std::chrono::steady_clock::now();
+
+    return {std::chrono::duration<double>(submitted - start).count(),
+            std::chrono::duration<double>(started - submitted).count()};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int orders = argc > 1 ? std::atoi(argv[1]) : 5000;
+    int symbols = argc > 2 ? std::atoi(argv[2]) : 500;
+    int rounds = argc > 3 ? std::atoi(argv[3]) : 3;
+
+    auto basket = makeBasket(orders, symbols);
+
+    // Best of N rounds for each path
+    Timing single{1e300, 1e300};
+    Timing batch{1e300, 1e300};
+    for (int r = 0; r < rounds; ++r) {
+        Timing s = runSingle(basket);
+        Timing b = runBatch(basket);
+        single = {std::min(single.submitSeconds, s.submitSeconds), std::min(single.startSeconds, s.startSeconds)};
+        batch = {std::min(batch.submitSeconds, b.submitSeconds), std::min(batch.startSeconds, b.startSeconds)};
+    }
+
+    auto rate = [&](double seconds) { return static_cast<double>(orders) / seconds; };
+    std::cerr << "orders=" << orders << " symbols=" << symbols << " rounds=" << rounds << std::endl;
+    std::cerr << std::left << std::setw(10) << "path" << std::setw(18) << "submit orders/s"
+              << std::setw(18) << "start orders/s" << std::endl;
+    std::cerr << std::fixed << std::setprecision(0);
+    std::cerr << std::setw(10) << "single" << std::setw(18) << rate(single.submitSeconds)
+              << std::setw(18) << rate(single.startSeconds) << std::endl;
+    std::cerr << std::setw(10) << "batch" << std::setw(18) << rate(batch.submitSeconds)
+              << std::setw(18) << rate(batch.startSeconds) << std::endl;
+    std::cerr << std::setprecision(2) << "submit speedup " << single.submitSeconds / batch.submitSeconds
+              << "x, start speedup " << single.startSeconds / batch.startSeconds << "x" << std::endl;
+    return 0;
+}
@@ -0,0 +1,110 @@
+// Throughput of execution_scheduler on a many-order workload: every order
+// submits its chunks with the order as affinity key, and each chunk does a
+// fixed amount of model work. Compares the single timer thread against
+// worker pools of increasing size, for both queue backends.
+//
+// The skewed run puts 90% of the chunks on 8 hot symbols that all hash to the
+// same worker, the rest spread over `orders` keys; without stealing whole
+// symbol queues, that one worker does nearly all of the work.
+//
+// usage: scheduler_benchmark [orders] [chunks] [workPerChunk]
+#include "execution_scheduler.hpp"
+#include "market_impact_model.hpp"
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+double chunkWork(int iterations) {
+    double acc = 0.0;
+    for (int i = 0; i < iterations; ++i) {
+        acc += std::sinh(1e-3 * i) / (1.0 + i);
+    }
+    return acc;
+}
+
+struct Run {
+    double rate{0.0};
+    uint64_t steals{0};
+};
+
+// Key of the o-th order; skewed runs send 9 in 10 to a hot key homed on worker 1
+uint64_t keyFor(int o, bool skewed, size_t workers) {
+    if (!skewed || o % 10 == 9) {
+        return static_cast<uint64_t>(o) + 1;
+    }
+    return 1 + static_cast<uint64_t>(o % 8) * std::max<size_t>(workers, 1);
+}
+
+Run runOnce(SchedulerBackend backend, size_t workers, int orders, int chunks, int work, bool skewed) {
+    SchedulerConfig config;
+    config.backend = backend;
+    config.workerThreads = workers;
+    execution_scheduler scheduler(config);
+    scheduler.start();
+
+    const size_t total = static_cast<size_t>(orders) * chunks;
+    std::atomic<size_t> done{0};
+    std::atomic<double> sink{0.0};
+
+    auto start = std::chrono::steady_clock::now();
+    for (int c = 0; c < chunks; ++c) {
+        for (int o = 0; o < orders; ++o) {
+            scheduler.scheduleAt(start, [&, work]() {
+                sink.store(chunkWork(work), std::memory_order_relaxed);
+                done.fetch_add(1, std::memory_order_release);
+            }, keyFor(o, skewed, workers));
+        }
+    }
+    while (done.load(std::memory_order_acquire) < total) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    Run run{static_cast<double>(total) / elapsed, scheduler.stolenTasks()};
+    scheduler.stop();
+    return run;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int orders = argc > 1 ? std::atoi(argv[1]) : 2000;
+    int chunks = argc > 2 ? std::atoi(argv[2]) : 50;
+    int work = argc > 3 ? std::atoi(argv[3]) : 200;
+
+    std::vector<size_t> workerCounts{0, 1, 2, 4};
+    size_t hw = std::max(1u, std::thread::hardware_concurrency());
+    if (hw > 4) {
+        workerCounts.push_back(hw);
+    }
+
+    std::cout << "orders=" << orders << " chunks=" << chunks << " work=" << work
+              << " hw_threads=" << hw << std::endl;
+    std::cout << std::left << std::setw(14) << "backend" << std::setw(10) << "load" << std::setw(10) << "workers"
+              << std::setw(16) << "tasks/sec" << std::setw(10) << "speedup" << "steals" << std::endl;
+
+    for (auto backend : {SchedulerBackend::BinaryHeap, SchedulerBackend::TimingWheel}) {
+        for (bool skewed : {false, true}) {
+            double baseline = 0.0;
+            for (size_t workers : workerCounts) {
+                Run run = runOnce(backend, workers, orders, chunks, work, skewed);
+                if (workers == 0) {
+                    baseline = run.rate;
+                }
+                std::cout << std::left << std::setw(14)
+                          << (backend == SchedulerBackend::BinaryHeap ? "heap" : "wheel")
+                          << std::setw(10) << (skewed ? "skewed" : "uniform")
+                          << std::setw(10) << (workers == 0 ? std::string("inline") : std::to_string(workers))
+                          << std::setw(16) << std::fixed << std::setprecision(0) << run.rate
+                          << std::setw(10) << std::setprecision(2) << run.rate / baseline << run.steals << std::endl;
+            }
+        }
+    }
+    return 0;
+}
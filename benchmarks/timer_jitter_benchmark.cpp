@@ -0,0 +1,137 @@
+// Dispatch jitter and recurring-task drift of execution_scheduler on the real
+// clock. Jitter: one-shot tasks at random deadlines 200-800 us apart, timed
+// by the scheduler's own dispatch lag histogram (start - deadline), for each
+// SchedulerWait. Drift: a 1 ms task that works for 200 us per run, re-armed
+// from its own start time (how recurring tasks used to work) against
+// scheduleEvery, which anchors every run to the first.
+//
+// usage: timer_jitter_benchmark [tasks] [driftRuns]
+#include "execution_scheduler.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void burn(std::chrono::nanoseconds duration) {
+    auto until = Clock::now() + duration;
+    while (Clock::now() < until) {
+    }
+}
+
+LatencySummary measureJitter(SchedulerWait wait, int tasks) {
+    SchedulerConfig config;
+    config.wait = wait;
+    execution_scheduler scheduler(config);
+    scheduler.start();
+
+    std::mt19937_64 rng(11);
+    std::atomic<int> ran{0};
+    auto deadline = Clock::now() + std::chrono::milliseconds(10);
+    for (int i = 0; i < tasks; ++i) {
+        deadline += std::chrono::microseconds(200 + rng() % 600);
+        scheduler.scheduleAt(deadline, [&ran] { ran.fetch_add(1, std::memory_order_relaxed); });
+    }
+    while (ran.load(std::memory_order_relaxed) < tasks) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    scheduler.stop();
+    return scheduler.dispatchLag();
+}
+
+struct Drift {
+    double phaseUs{0.0};   // last run against the tick it ran for
+    long skipped{0};       // ticks with no run of their own
+};
+
+// Re-armed runs are due at first + k * interval for the k-th run, so all of
+// their lag accumulates; anchored runs are due on the tick grid from the first
+Drift measureDrift(bool anchored, int runs) {
+    constexpr auto kInterval = std::chrono::milliseconds(1);
+    constexpr auto kWork = std::chrono::microseconds(200);
+    execution_scheduler scheduler;
+    scheduler.start();
+
+    std::atomic<int> count{0};
+    Clock::time_point first;
+    Clock::time_point last;
+    std::function<void()> rearm;
+    auto body = [&] {
+        auto now = Clock::now();
+        int k = count.load(std::memory_order_relaxed);
+        if (k == 0) {
+            first = now;
+        }
+        last = now;
+        burn(kWork);
+        count.store(k + 1, std::memory_order_release);
+    };
+    if (anchored) {
+        scheduler.scheduleEvery(kInterval, [&] {
+            if (count.load(std::memory_order_relaxed) < runs) {
+                body();
+            }
+        });
+    } else {
+        rearm = [&] {
+            auto started = scheduler.now();
+            body();
+            if (count.load(std::memory_order_relaxed) < runs) {
+                scheduler.scheduleAt(started + kInterval, rearm);
+            }
+        };
+        scheduler.scheduleAt(scheduler.now(), rearm);
+    }
+    while (count.load(std::memory_order_acquire) < runs) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    scheduler.stop();
+
+    Drift drift;
+    auto elapsed = last - first;
+    long tick = anchored ? static_cast<long>(elapsed / kInterval) : runs - 1;
+    drift.phaseUs = std::chrono::duration<double, std::micro>(elapsed - kInterval * tick).count();
+    drift.skipped = tick - (runs - 1);
+    return drift;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int tasks = argc > 1 ? std::atoi(argv[1]) : 2000;
+    int driftRuns = argc > 2 ? std::atoi(argv[2]) : 1000;
+
+    const std::pair<const char*, SchedulerWait> waits[] = {
+        {"condvar", SchedulerWait::ConditionVariable},
+        {"sleep+spin", SchedulerWait::SleepSpin},
+        {"timerfd", SchedulerWait::TimerFd},
+    };
+    std::cout << "dispatch lag, " << tasks << " one-shot tasks (us)\n"
+              << std::left << std::setw(12) << "wait" << std::right << std::setw(10) << "p50"
+              << std::setw(10) << "p90" << std::setw(10) << "p99" << std::setw(10) << "p99.9"
+              << std::setw(10) << "max" << "\n";
+    for (const auto& [name, wait] : waits) {
+        LatencySummary lag = measureJitter(wait, tasks);
+        std::cout << std::left << std::setw(12) << name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << lag.p50 / 1e3 << std::setw(10) << lag.p90 / 1e3
+                  << std::setw(10) << lag.p99 / 1e3 << std::setw(10) << lag.p999 / 1e3
+                  << std::setw(10) << lag.max / 1e3 << "\n";
+    }
+
+    std::cout << "\nafter " << driftRuns << " runs of a 1 ms task doing 200 us of work\n";
+    for (bool anchored : {false, true}) {
+        Drift drift = measureDrift(anchored, driftRuns);
+        std::cout << std::left << std::setw(24) << (anchored ? "scheduleEvery" : "re-armed from its start")
+                  << std::right << std::fixed << std::setprecision(1) << std::setw(12) << drift.phaseUs
+                  << " us behind its tick" << std::setw(8) << drift.skipped << " ticks skipped\n";
+    }
+    std::cout << std::flush;
+    return 0;
+}
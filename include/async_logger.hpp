@@ -0,0 +1,193 @@
+#pragma once
+
+#include "thread_tuning.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+enum class LogLevel : uint8_t {
+    Debug,
+    Info,
+    Warn,
+    Error,
+    Off
+};
+
+// Statements below this level compile to nothing (arguments aren't evaluated).
+// 0 = Debug, 1 = Info, 2 = Warn, 3 = Error, 4 = Off.
+#ifndef AC_LOG_MIN_LEVEL
+#define AC_LOG_MIN_LEVEL 1
+#endif
+
+enum class LogFormat {
+    Text, // 2026-01-01T12:00:00.000000Z INFO  [t1] message
+    Json  // one object per line: ts, level, thread, msg, args
+};
+
+struct LoggerConfig {
+    std::string path;            // empty = stdout
+    LogFormat format{LogFormat::Text};
+    LogLevel level{LogLevel::Info}; // runtime filter on top of AC_LOG_MIN_LEVEL
+    size_t recordsPerThread{1024};  // ring size for threads that start logging after this
+    std::chrono::milliseconds flushInterval{1};
+};
+
+// Fixed-size record: the message is a string literal with {} placeholders and
+// the arguments are stored raw. Formatting happens on the writer thread.
+struct LogRecord {
+    static constexpr size_t kMaxArgs = 8;
+    static constexpr size_t kTextBytes = 120;
+
+    enum ArgType : uint8_t { Int, UInt, Double, Bool, Text };
+
+    int64_t timestampNs;
+    const char* format;
+    LogLevel level;
+    uint8_t argCount;
+    uint8_t textUsed;
+    ArgType types[kMaxArgs];
+    union Value {
+        int64_t i;
+        uint64_t u;
+        double d;
+        struct {
+            uint8_t offset;
+            uint8_t length;
+        } text;
+    } values[kMaxArgs];
+    char text[kTextBytes]; // string arguments, truncated if they don't fit
+};
+
+// Asynchronous logger. Each thread appends to its own lock-free SPSC ring;
+// a background writer drains every ring, formats and writes in batches. A
+// full ring drops the record (counted) instead of blocking the caller.
+class async_logger {
+public:
+    static async_logger& instance();
+
+    ~async_logger();
+    async_logger(const async_logger&) = delete;
+    async_logger& operator=(const async_logger&) = delete;
+
+    void configure(const LoggerConfig& config);
+    void setLevel(LogLevel level) { level_.store(level, std::memory_order_relaxed); }
+    bool enabled(LogLevel level) const { return level >= level_.load(std::memory_order_relaxed); }
+
+    // Writes out everything logged so far by any thread
+    void flush();
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    std::vector<NamedThread> threads(); // the writer, "ac-logger"
+
+    template <typename... Args>
+    void log(LogLevel level, const char* format, const Args&... args) {
+        static_assert(sizeof...(Args) <= LogRecord::kMaxArgs, "too many log arguments");
+        if (!enabled(level)) {
+            return;
+        }
+        LogRecord* record = claim_();
+        if (record == nullptr) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        record->timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        record->format = format;
+        record->level = level;
+        record->argCount = 0;
+        record->textUsed = 0;
+        (encode_(*record, args), ...);
+        commit_();
+    }
+
+private:
+    struct ThreadBuffer {
+        explicit ThreadBuffer(size_t capacity, uint32_t id)
+            : records(capacity), threadId(id) {}
+
+        std::vector<LogRecord> records;
+        uint32_t threadId;
+        alignas(64) std::atomic<size_t> head{0}; // writer
+        alignas(64) std::atomic<size_t> tail{0}; // owning thread
+        std::atomic<bool> retired{false};
+    };
+
+    async_logger();
+
+    ThreadBuffer& localBuffer_();
+    LogRecord* claim_();
+    void commit_();
+
+    template <typename T>
+    static void encode_(LogRecord& record, const T& value) {
+        size_t index = record.argCount++;
+        auto& slot = record.values[index];
+        if constexpr (std::is_same_v<T, bool>) {
+            record.types[index] = LogRecord::Bool;
+            slot.u = value ? 1 : 0;
+        } else if constexpr (std::is_floating_point_v<T>) {
+            record.types[index] = LogRecord::Double;
+            slot.d = static_cast<double>(value);
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            record.types[index] = LogRecord::Int;
+            slot.i = static_cast<int64_t>(value);
+        } else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+            record.types[index] = LogRecord::UInt;
+            slot.u = static_cast<uint64_t>(value);
+        } else {
+            std::string_view text(value);
+            size_t length = std::min(text.size(), LogRecord::kTextBytes - record.textUsed);
+            std::memcpy(record.text + record.textUsed, text.data(), length);
+            record.types[index] = LogRecord::Text;
+            slot.text.offset = record.textUsed;
+            slot.text.length = static_cast<uint8_t>(length);
+            record.textUsed = static_cast<uint8_t>(record.textUsed + length);
+        }
+    }
+
+    void run_();
+    void drainAll_(); // caller holds writeMutex_
+    void format_(const LogRecord& record, uint32_t threadId);
+
+    std::atomic<LogLevel> level_{LogLevel::Info};
+    std::atomic<size_t> recordsPerThread_{1024};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint32_t> nextThreadId_{1};
+
+    std::mutex registryMutex_;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+
+    std::mutex writeMutex_; // one consumer at a time: the writer thread or flush()
+    FILE* out_{stdout};
+    bool ownsOut_{false};
+    LogFormat outputFormat_{LogFormat::Text};
+    std::string line_;
+
+    std::chrono::milliseconds flushInterval_{1};
+    std::mutex wakeMutex_;
+    std::condition_variable wake_;
+    bool stopping_{false};
+    std::thread writer_;
+};
+
+#define AC_LOG(level, ...)                                                        \
+    do {                                                                          \
+        if constexpr (static_cast<int>(level) >= AC_LOG_MIN_LEVEL) {              \
+            ::async_logger::instance().log(level, __VA_ARGS__);                   \
+        }                                                                         \
+    } while (0)
+
+#define AC_LOG_DEBUG(...) AC_LOG(LogLevel::Debug, __VA_ARGS__)
+#define AC_LOG_INFO(...) AC_LOG(LogLevel::Info, __VA_ARGS__)
+#define AC_LOG_WARN(...) AC_LOG(LogLevel::Warn, __VA_ARGS__)
+#define AC_LOG_ERROR(...) AC_LOG(LogLevel::Error, __VA_ARGS__)
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Row-major dense matrix
+class dense_matrix {
+public:
+    dense_matrix() = default;
+    dense_matrix(size_t rows, size_t cols, double fill = 0.0)
+        : rows_(rows), cols_(cols), data_(rows * cols, fill) {}
+
+    static dense_matrix identity(size_t n);
+    // Copies a row-major rows x cols buffer; throws std::invalid_argument on a size mismatch
+    static dense_matrix fromRowMajor(size_t rows, size_t cols, const std::vector<double>& values);
+
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+    double& operator()(size_t r, size_t c) { return data_[r * cols_ + c]; }
+    double operator()(size_t r, size_t c) const { return data_[r * cols_ + c]; }
+    double* row(size_t r) { return data_.data() + r * cols_; }
+    const double* row(size_t r) const { return data_.data() + r * cols_; }
+    const std::vector<double>& values() const { return data_; }
+
+    dense_matrix transposed() const;
+
+private:
+    size_t rows_{0};
+    size_t cols_{0};
+    std::vector<double> data_;
+};
+
+// Threads kept for the length of one factorization so each parallel region
+// costs a futex wake rather than a thread spawn. The calling thread is
+// worker 0; regions run one at a time.
+class parallel_team {
+public:
+    explicit parallel_team(unsigned threads = 0); // 0 = every hardware thread
+    ~parallel_team();
+
+    parallel_team(const parallel_team&) = delete;
+    parallel_team& operator=(const parallel_team&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(threads_.size()) + 1; }
+
+    // Runs fn(worker, workers) on every member and waits; rethrows the first exception
+    void run(const std::function<void(unsigned worker, unsigned workers)>& fn);
+
+    // Splits [0, count) into one contiguous range per worker, or runs inline
+    // when there are fewer than minPerWorker items per worker
+    void parallelFor(size_t count, size_t minPerWorker, const std::function<void(size_t begin, size_t end)>& fn);
+
+private:
+    void workerLoop_(unsigned worker);
+    void execute_(unsigned worker);
+
+    std::vector<std::thread> threads_;
+    const std::function<void(unsigned, unsigned)>* task_{nullptr};
+    std::atomic<uint32_t> generation_{0};
+    std::atomic<uint32_t> remaining_{0};
+    std::atomic<bool> stopping_{false};
+    std::mutex errorMutex_;
+    std::exception_ptr error_;
+};
+
+// Cache-blocked dense kernels used by the portfolio model. Each one splits
+// its work over a parallel_team; results don't depend on the team size.
+namespace linalg {
+
+// A = L L^T in place: L in the lower triangle, upper triangle zeroed.
+// Right-looking with 64-wide panels. Throws std::invalid_argument unless A
+// is symmetric positive definite.
+void choleskyInPlace(dense_matrix& a, parallel_team& team);
+
+// B <- L^{-1} B for lower-triangular L, in column slices that stay in cache
+void solveLowerInPlace(const dense_matrix& l, dense_matrix& b, parallel_team& team);
+
+// x <- L^{-T} x for one vector
+void solveLowerTransposedInPlace(const dense_matrix& l, double* x);
+
+// Symmetric eigendecomposition A = U diag(eigenvalues) U^T. A is overwritten.
+// Row j of eigenvectorRows is the eigenvector of eigenvalues[j] (unsorted).
+// Householder tridiagonalization, then implicit QL; the reflectors and the
+// recorded rotations are applied to column slices of U^T in parallel.
+void symmetricEigen(dense_matrix& a, std::vector<double>& eigenvalues, dense_matrix& eigenvectorRows,
+                    parallel_team& team);
+
+} // namespace linalg
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "execution_metrics.hpp"
+#include "market_data.hpp"
+#include "mpsc_queue.hpp"
+#include "order_store.hpp"
+#include "thread_tuning.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+enum class EngineEventType : uint8_t {
+    Execution,
+    Status,
+    Progress
+};
+
+// Plain data so publishing never allocates; ids are turned back into strings
+// on the dispatcher thread
+struct EngineEvent {
+    EngineEventType type{EngineEventType::Execution};
+    OrderStatus status{OrderStatus::PENDING};
+    OrderHandle order{kInvalidOrderHandle};
+    SymbolId symbol{kInvalidSymbol};
+    double shares{0.0};
+    double price{0.0};
+    double totalExecuted{0.0};
+    double totalShares{0.0};
+    double progressPercent{0.0};
+};
+
+enum class DispatchOverflow {
+    Drop,  // publish never waits; events that don't fit are counted and lost
+    Block  // publisher spins until the dispatcher frees room. Callbacks must not
+           // call back into the engine, or a full queue can deadlock.
+};
+
+struct DispatcherConfig {
+    bool async{true}; // false = deliver on the publishing thread, one event per batch
+    size_t capacity{65536};
+    size_t maxBatch{256};
+    DispatchOverflow overflow{DispatchOverflow::Drop};
+};
+
+struct DispatchStats {
+    size_t queueDepth{0};
+    uint64_t published{0};
+    uint64_t delivered{0};
+    uint64_t dropped{0};
+    uint64_t backpressureWaits{0}; // publishes that found the queue full under Block
+    uint64_t batches{0};
+};
+
+// Moves engine callbacks off the scheduler threads. Producers push into a
+// bounded MPSC ring; one dispatcher thread drains it and hands the sink up to
+// maxBatch events at a time, so per-batch costs (e.g. taking the Python GIL)
+// are paid once per batch rather than once per event.
+class event_dispatcher {
+public:
+    using Sink = std::function<void(const EngineEvent* events, size_t count)>;
+
+    event_dispatcher(const DispatcherConfig& config, Sink sink);
+    ~event_dispatcher();
+
+    event_dispatcher(const event_dispatcher&) = delete;
+    event_dispatcher& operator=(const event_dispatcher&) = delete;
+
+    void start();
+    void stop(); // delivers everything already queued before returning
+
+    void publish(const EngineEvent& event);
+    void flush(); // waits until every event published so far has been delivered
+
+    bool isAsync() const { return async_; }
+    DispatchStats stats() const;
+    std::vector<NamedThread> threads(); // "ac-dispatch", when async and started
+
+private:
+    void run_();
+    size_t drain_(std::vector<EngineEvent>& batch);
+    void wake_();
+
+    bool async_;
+    size_t maxBatch_;
+    DispatchOverflow overflow_;
+    Sink sink_;
+    mpsc_queue<EngineEvent> queue_;
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint32_t> sleeping_{0};
+
+    std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> delivered_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> backpressureWaits_{0};
+    std::atomic<uint64_t> batches_{0};
+};
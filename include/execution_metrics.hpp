@@ -1,6 +1,8 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
+#include <string>
 
 // execution_metrics.hpp  
 struct ExecutionMetrics {
@@ -16,6 +18,13 @@ struct ExecutionMetrics {
     void printReport() const;
 };
 
+// One fill of an order; plain doubles so a history maps onto an (n, 3) array
+struct FillRecord {
+    double time;   // seconds: model time for simulated fills, since the order started for venue fills
+    double price;
+    double shares;
+};
+
 enum class OrderStatus {
     PENDING,
     ACTIVE, 
@@ -25,6 +34,17 @@ enum class OrderStatus {
     FAILED
 };
 
+// Per-order row of TradingEngine::getAllOrderMetrics()
+struct OrderMetricsRow {
+    uint32_t handle;
+    int32_t status; // OrderStatus
+    double totalShares;
+    double executedShares;
+    double averageExecutionPrice;
+    double implementationShortfall;
+    double progressPercent;
+};
+
 struct ExecutionReport {
     std::string orderId;
     double executedShares;
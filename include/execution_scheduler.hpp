@@ -7,32 +7,70 @@
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
-#include <queue>
 #include <utility>
 #include <memory>
+#include "task_queue.hpp"
+#include "worker_pool.hpp"
+#include "scheduler_clock.hpp"
+#include "latency_histogram.hpp"
+#include "thread_tuning.hpp"
+
+enum class SchedulerBackend {
+    BinaryHeap,   // O(log n) insert/pop, exact ordering
+    TimingWheel   // O(1) insert/expiry, deadlines rounded up to wheelTick
+};
+
+// How the timer thread waits for the next deadline
+enum class SchedulerWait {
+    ConditionVariable, // wait_until on the queue's condition variable
+    SleepSpin,         // sleep until spinWindow before the deadline, then spin on the clock
+    TimerFd,           // Linux: poll a timerfd armed at the absolute deadline, which
+                       // is not subject to timer slack; elsewhere as ConditionVariable
+};
+
+struct SchedulerConfig {
+    SchedulerBackend backend{SchedulerBackend::BinaryHeap};
+    std::chrono::nanoseconds wheelTick{std::chrono::milliseconds(1)};
+    size_t workerThreads{0}; // 0 = run tasks on the timer thread itself
+    // nullptr = real time. A simulated_clock puts the scheduler in discrete-event
+    // mode: no background threads, and runUntil()/runUntilIdle() execute tasks on
+    // the caller's thread, jumping the clock straight to each next deadline.
+    std::shared_ptr<scheduler_clock> clock;
+    // The sleeping waits wake late by OS scheduling jitter plus, for futex
+    // waits, the thread's timer slack; spinning trades a core for the tail
+    SchedulerWait wait{SchedulerWait::ConditionVariable};
+    std::chrono::nanoseconds spinWindow{std::chrono::microseconds(100)};
+};
+
+// Returned by the schedule* calls; pass it back to cancel() or reschedule().
+// Cheap to copy, and safe to keep after the task has run.
+class TaskHandle {
+public:
+    TaskHandle() = default;
+
+    // true while the task is queued and has not been dispatched yet
+    bool pending() const {
+        return state_ && state_->token.load(std::memory_order_relaxed) < TaskState::kCancelled;
+    }
+    explicit operator bool() const { return state_ != nullptr; }
+    void reset() { state_.reset(); }
+
+private:
+    friend class execution_scheduler;
+    explicit TaskHandle(std::shared_ptr<TaskState> state) : state_(std::move(state)) {}
+
+    std::shared_ptr<TaskState> state_;
+};
 
 class execution_scheduler
 {
 public:
-    using Task = std::function<void()>;
-    using TimePoint = std::chrono::steady_clock::time_point;
-
-    // represents a scheduled task with execution time and the task itself
-    struct ScheduledTask{
-        TimePoint executionTime;
-        Task task;
-        std::chrono::milliseconds interval{0}; // for recurring tasks 
-        bool isRecurring() const {
-            return interval.count() > 0; 
-        }
-
-        // (earlier time has higher priority)
-        bool operator<(const ScheduledTask& other) const {
-            return executionTime > other.executionTime; // Min-heap behaviour
-        }
-    };
+    using ScheduledTask = ::ScheduledTask;
+    using Task = ScheduledTask::Task;
+    using TimePoint = ScheduledTask::TimePoint;
 
     execution_scheduler();
+    explicit execution_scheduler(const SchedulerConfig& config);
     ~execution_scheduler();
 
     //Disable Copy 
@@ -47,19 +85,65 @@ public:
     void stop();
     bool isRunning() const { return running_.load(); }
 
-    void scheduleAt(const TimePoint& time, Task task);
-    void scheduleAfter(const std::chrono::milliseconds& delay, Task task);
-    void scheduleEvery(const std::chrono::milliseconds& interval, Task task);
+    // affinityKey != 0 runs tasks with the same key in order, one at a time
+    TaskHandle scheduleAt(const TimePoint& time, Task task, uint64_t affinityKey = 0);
+    TaskHandle scheduleAfter(const std::chrono::nanoseconds& delay, Task task, uint64_t affinityKey = 0);
+    // Runs now, then at now + k * interval for every k: a run's own duration
+    // never shifts later ones. Ticks missed while a run overran are skipped
+    // rather than run back to back.
+    TaskHandle scheduleEvery(const std::chrono::nanoseconds& interval, Task task, uint64_t affinityKey = 0);
+
+    // O(1): returns true if the task was still queued and will now never run.
+    // A recurring task that is mid-run is not interrupted but won't re-arm.
+    bool cancel(const TaskHandle& handle);
+    // Moves a queued task to a new time (O(1) on the timing wheel, O(log n) on the heap).
+    // Returns false if it was already dispatched or cancelled.
+    bool reschedule(const TaskHandle& handle, const TimePoint& time);
+
+    // Discrete-event mode only: run every task due up to `limit`, advancing the
+    // simulated clock between events. Returns the number of tasks executed.
+    // runUntilIdle() stops when the queue drains, so recurring tasks need runUntil().
+    size_t runUntil(const TimePoint& limit);
+    size_t runUntilIdle() { return runUntil(TimePoint::max()); }
+
+    TimePoint now() const { return clock_->now(); }
+    bool isSimulated() const { return simulatedClock_ != nullptr; }
+
+    size_t pendingTasks() const; // live tasks only, excluding cancelled entries not yet purged
+    SchedulerBackend backend() const { return config_.backend; }
+    size_t workerCount() const { return pool_ ? pool_->size() : 0; }
+    uint64_t stolenTasks() const { return pool_ ? pool_->steals() : 0; }
+    // The timer thread ("ac-timer") and pool workers, while started
+    std::vector<NamedThread> threads();
 
-    size_t pendingTasks() const;
+    // How late tasks start against their deadline (scheduler clock), and how
+    // long they run (wall clock)
+    LatencySummary dispatchLag() const { return dispatchLag_.summary(); }
+    LatencySummary runTime() const { return runTime_.summary(); }
 
 private:
     void workerThread();
-    void addTask(const ScheduledTask& task);
+    TaskHandle addTask(const TimePoint& time, Task task, std::chrono::nanoseconds interval, uint64_t affinityKey);
+    void waitUntil_(std::unique_lock<std::mutex>& lock, TimePoint deadline); // lock held on entry and exit
+    void wake_(TimePoint time); // after queueing work due at time; caller holds queueMutex_
+    void runTask_(ScheduledTask& task);
+    void markStale_(); // caller holds queueMutex_
+    void claimLive_(std::vector<ScheduledTask>& due); // caller holds queueMutex_
 
+    SchedulerConfig config_;
+    std::shared_ptr<scheduler_clock> clock_;
+    simulated_clock* simulatedClock_{nullptr}; // set when clock_ is simulated
     mutable std::mutex queueMutex_;
     std::condition_variable condition_;
-    std::priority_queue<ScheduledTask> tasks_;
+    std::unique_ptr<task_queue> tasks_;
+    size_t staleEntries_{0}; // cancelled/superseded entries still stored in tasks_
+    std::atomic<uint64_t> queueChanges_{0}; // ends a SleepSpin spin early
+    int timerFd_{-1};                       // SchedulerWait::TimerFd
+    int wakeFd_{-1};                        // eventfd that interrupts the timerfd poll
+    TimePoint armedDeadline_{TimePoint::max()}; // what the poll waits for; max = not polling
     std::atomic<bool> running_{false};
     std::thread workerThread_;
+    std::unique_ptr<worker_pool> pool_;
+    latency_histogram dispatchLag_;
+    latency_histogram runTime_;
 };
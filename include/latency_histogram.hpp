@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+
+// Percentiles of a latency histogram, all in nanoseconds
+struct LatencySummary {
+    uint64_t count{0};
+    double mean{0.0};
+    uint64_t p50{0};
+    uint64_t p90{0};
+    uint64_t p99{0};
+    uint64_t p999{0};
+    uint64_t max{0};
+};
+
+// Log-linear (HDR-style) histogram of nanosecond values: 32 linear sub-buckets
+// per power of two, so any recorded value is reported within ~3% and the full
+// uint64 range fits in 1920 counters. record() is a couple of relaxed atomic
+// adds and is safe from any thread; summary() is an approximate snapshot.
+class latency_histogram {
+public:
+    void record(uint64_t nanoseconds) {
+        buckets_[indexOf_(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(nanoseconds, std::memory_order_relaxed);
+        uint64_t seen = max_.load(std::memory_order_relaxed);
+        while (nanoseconds > seen && !max_.compare_exchange_weak(seen, nanoseconds, std::memory_order_relaxed)) {
+        }
+    }
+
+    template <typename Rep, typename Period>
+    void record(std::chrono::duration<Rep, Period> duration) {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+        record(ns > 0 ? static_cast<uint64_t>(ns) : 0);
+    }
+
+    LatencySummary summary() const {
+        std::array<uint64_t, kBuckets> counts;
+        uint64_t total = 0;
+        for (size_t i = 0; i < kBuckets; ++i) {
+            counts[i] = buckets_[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+
+        LatencySummary result;
+        result.count = total;
+        result.max = max_.load(std::memory_order_relaxed);
+        if (total == 0) {
+            return result;
+        }
+        result.mean = static_cast<double>(sum_.load(std::memory_order_relaxed)) /
+                      static_cast<double>(count_.load(std::memory_order_relaxed));
+
+        // Walk the buckets once, filling each percentile as its rank is passed
+        const double levels[] = {0.50, 0.90, 0.99, 0.999};
+        uint64_t* outputs[] = {&result.p50, &result.p90, &result.p99, &result.p999};
+        size_t next = 0;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBuckets && next < 4; ++i) {
+            seen += counts[i];
+            while (next < 4 && static_cast<double>(seen) >= levels[next] * static_cast<double>(total)) {
+                *outputs[next++] = std::min(highestIn_(i), result.max);
+            }
+        }
+        return result;
+    }
+
+    void reset() {
+        for (auto& bucket : buckets_) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        count_.store(0, std::memory_order_relaxed);
+        sum_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr int kSubBits = 5;
+    static constexpr uint64_t kSub = uint64_t{1} << kSubBits;
+    static constexpr size_t kBuckets = (64 - kSubBits + 1) * kSub;
+
+    static size_t indexOf_(uint64_t value) {
+        if (value < kSub) {
+            return static_cast<size_t>(value);
+        }
+        int exponent = std::bit_width(value) - 1; // >= kSubBits
+        uint64_t sub = (value >> (exponent - kSubBits)) & (kSub - 1);
+        return static_cast<size_t>((exponent - kSubBits + 1) * kSub + sub);
+    }
+
+    static uint64_t highestIn_(size_t index) {
+        if (index < kSub) {
+            return index;
+        }
+        int exponent = static_cast<int>(index / kSub) + kSubBits - 1;
+        uint64_t sub = index % kSub;
+        uint64_t low = (kSub + sub) << (exponent - kSubBits);
+        return low + (uint64_t{1} << (exponent - kSubBits)) - 1;
+    }
+
+    std::array<std::atomic<uint64_t>, kBuckets> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
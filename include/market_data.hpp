@@ -1,6 +1,9 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
+#include <string>
+#include <type_traits>
 
 struct MarketData {
     std::string symbol;
@@ -11,4 +14,39 @@ struct MarketData {
     double lastPrice;
     double volume;
     std::chrono::system_clock::time_point timestamp;
-};
\ No newline at end of file
+};
+
+// Dense id handed out by symbol_table; indexes the per-symbol quote slots
+using SymbolId = uint32_t;
+constexpr SymbolId kInvalidSymbol = UINT32_MAX;
+
+// MarketData without the symbol string: fixed size and trivially copyable so
+// the feed can publish it without allocating
+struct MarketQuote {
+    double bidPrice;
+    double askPrice;
+    double lastPrice;
+    double volume;
+    int64_t timestampNs; // system_clock nanoseconds since epoch
+    int32_t bidSize;
+    int32_t askSize;
+
+    static MarketQuote from(const MarketData& data) {
+        return MarketQuote{
+            data.bidPrice, data.askPrice, data.lastPrice, data.volume,
+            std::chrono::duration_cast<std::chrono::nanoseconds>(data.timestamp.time_since_epoch()).count(),
+            data.bidSize, data.askSize
+        };
+    }
+
+    MarketData toMarketData(const std::string& symbol) const {
+        return MarketData{
+            symbol, bidPrice, askPrice, bidSize, askSize, lastPrice, volume,
+            std::chrono::system_clock::time_point(
+                std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(timestampNs)))
+        };
+    }
+};
+
+static_assert(std::is_trivially_copyable_v<MarketQuote>);
+static_assert(sizeof(MarketQuote) % sizeof(uint64_t) == 0);
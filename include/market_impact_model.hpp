@@ -1,7 +1,11 @@
 #pragma once
 
+#include "trajectory_kernel.hpp"
+#include "philox_rng.hpp"
+#include <array>
 #include <vector>
-#include <random>
+#include <cstdint>
+#include <span>
 
 class AlmgrenChrissModel {
 public:
@@ -9,20 +13,63 @@ public:
                       double initialPrice, double totalShares, double timeHorizon);
     
     std::vector<double> calculateOptimalSchedule(int intervals = 10);
+    // Closed-form plan for the unexecuted part of an order under updated
+    // sigma/eta. O(intervals); leaves the model's own parameters untouched.
+    std::vector<double> remainingSchedule(double remainingShares, double remainingTime,
+                                          int intervals, double sigma, double eta) const;
+    // Per-interval fractions of the order (sum 1) for the current parameters;
+    // independent of totalShares, so it can be shared between orders
+    std::vector<double> scheduleShape(int intervals) const;
+    // scheduleShape for an interval count known at compile time: unrolled,
+    // and instantiated for the shape picked at setParameters
+    template <int Intervals>
+    std::array<double, Intervals> fixedScheduleShape() const {
+        trajectory::Params unit = trajectory::Params::make(kappa_, timeHorizon_, 1.0);
+        return trajectory_.shape == trajectory::Shape::Linear
+            ? trajectory::fixedSchedule<trajectory::Shape::Linear, Intervals>(unit)
+            : trajectory::fixedSchedule<trajectory::Shape::Hyperbolic, Intervals>(unit);
+    }
     double computeRemainingShares(double t) const;
     double computeTradingRate(double t) const;
+    // Whole-trajectory versions (see trajectory_kernel.hpp): times outside
+    // [0, T] are clamped instead of throwing; out must match times in size
+    void computeRemainingShares(std::span<const double> times, std::span<double> out) const;
+    void computeTradingRate(std::span<const double> times, std::span<double> out) const;
+    // One step of the price path along the model's own trajectory, traded as
+    // a liquidation: permanent impact -gamma * v * dt
     double simulatePriceStep(double dt);
+    // The same step with `signedShares` traded in it instead (buys positive):
+    // permanent impact gamma * signedShares, up for buys and down for sells
+    double simulatePriceStep(double dt, double signedShares);
 
     double getElapsedTime() const { return elapsedTime_; }
     double getExecutedShares() const { return executedShares_; }
     double getCurrentPrice() const { return currentPrice_; }
     double getKappa() const { return kappa_; }
+    trajectory::Shape getTrajectoryShape() const { return trajectory_.shape; }
+    double getSigma() const { return sigma_; }
+    double getEta() const { return eta_; }
+    double getLambda() const { return lambda_; }
+    double getInitialPrice() const { return initialPrice_; }
+    double getTotalShares() const { return totalShares_; }
+    double getTimeHorizon() const { return timeHorizon_; }
+
+    // Re-seed this instance's random stream (each model owns its own
+    // generator). Models with the same seed and different streams draw
+    // independent price paths; same seed and stream, the same path.
+    void seed(uint64_t seed, uint64_t stream = 0);
+    // Skips the shocks of the next `steps` simulatePriceStep calls in O(1)
+    void skipDraws(uint64_t steps);
     
     void reset();
     void printState() const;
 
 private:
     void updateDerivedParameters_();
+    double step_(double dt, double permanentImpact);
+    static uint64_t defaultSeed_();
+    double nextNormal_();
+    void refillNormals_();
 
     double sigma_ = 0.02;         
     double gamma_ = 2.5e-6;      
@@ -33,16 +80,23 @@ private:
     double timeHorizon_ = 3600.0;  
 
     double kappa_ = 0.0;           
-    double sinhKappaT_ = 0.0;     
-    double coshKappaT_ = 1.0;      
+    // Trajectory constants and the per-shape evaluators, chosen in
+    // updateDerivedParameters_ so point evaluation never re-checks lambda/kappa
+    trajectory::Params trajectory_;
+    double (*remainingAt_)(const trajectory::Params&, double) = &trajectory::remainingAt<trajectory::Shape::Linear>;
+    double (*rateAt_)(const trajectory::Params&, double) = &trajectory::rateAt<trajectory::Shape::Linear>;
 
 
     double elapsedTime_ = 0.0;    
     double executedShares_ = 0.0; 
     double currentPrice_ = 150.0;  
 
-    // Random number generation - as static members for simplicity
-    static std::random_device rd_;
-    static std::mt19937 rng_;
-    static std::normal_distribution<double> norm_;
-};
\ No newline at end of file
+    // Random number generation - per instance so copies can run on separate
+    // threads. Shocks are drawn kNormalBatch at a time; normals_ always starts
+    // on a whole Philox block, so draw k of a stream is the same however the
+    // model got there (stepping, skipDraws, or a copy).
+    static constexpr uint32_t kNormalBatch = 16;
+    philox_rng rng_{defaultSeed_()};
+    uint32_t normalIndex_{kNormalBatch};
+    std::array<double, kNormalBatch> normals_{};
+};
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "market_impact_model.hpp"
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+// Distribution of implementation shortfall over many simulated executions
+struct MonteCarloResult {
+    size_t paths{0};
+    double mean{0.0};
+    double variance{0.0};
+    double stdDev{0.0};
+    std::vector<std::pair<double, double>> quantiles; // (level, cost)
+
+    double quantile(double level) const;
+};
+
+class MonteCarloSimulator {
+public:
+    // threads == 0 uses every hardware thread
+    explicit MonteCarloSimulator(unsigned threads = 0);
+
+    // Runs `paths` independent executions of `schedule` against copies of `model`.
+    // Path i draws from stream i of `seed`, so the costs are bit-identical
+    // whatever the thread count; each worker runs its paths on its own copy.
+    // Cost is the implementation shortfall in currency (positive = worse than arrival).
+    MonteCarloResult run(const AlmgrenChrissModel& model,
+                         const std::vector<double>& schedule,
+                         size_t paths,
+                         bool isBuy,
+                         uint64_t seed,
+                         const std::vector<double>& quantileLevels = {0.05, 0.25, 0.5, 0.75, 0.95, 0.99}) const;
+
+    unsigned threadCount() const { return threads_; }
+
+private:
+    static double simulatePath_(AlmgrenChrissModel& model, const std::vector<double>& schedule,
+                                double tau, bool isBuy);
+
+    unsigned threads_;
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+
+// Bounded lock-free queue for many producers and one consumer. Each cell
+// carries a sequence number (Vyukov's scheme): producers claim a cell with one
+// CAS on the tail, the consumer owns the head outright. tryPush fails instead
+// of blocking when the ring is full. T must be default constructible.
+template <typename T>
+class mpsc_queue {
+public:
+    explicit mpsc_queue(size_t capacity)
+        : mask_(roundUp_(capacity) - 1), cells_(new Cell[mask_ + 1]) {
+        for (size_t i = 0; i <= mask_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool tryPush(const T& value) {
+        size_t position = tail_.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells_[position & mask_];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // full: the consumer hasn't freed this cell yet
+            } else {
+                position = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer only
+    bool tryPop(T& out) {
+        Cell& cell = cells_[head_ & mask_];
+        if (cell.sequence.load(std::memory_order_acquire) != head_ + 1) {
+            return false;
+        }
+        out = cell.value;
+        cell.sequence.store(head_ + mask_ + 1, std::memory_order_release);
+        ++head_;
+        headPublished_.store(head_, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Approximate when called concurrently with producers
+    size_t size() const {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t head = headPublished_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<size_t> sequence;
+        T value{};
+    };
+
+    static size_t roundUp_(size_t capacity) {
+        if (capacity < 2) {
+            throw std::invalid_argument("mpsc_queue capacity must be at least 2");
+        }
+        size_t power = 1;
+        while (power < capacity) {
+            power <<= 1;
+        }
+        return power;
+    }
+
+    size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(64) std::atomic<size_t> tail_{0};
+    alignas(64) size_t head_{0};
+    std::atomic<size_t> headPublished_{0};
+};
@@ -0,0 +1,214 @@
+#pragma once
+
+#include "order_store.hpp"
+#include "thread_tuning.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Write-ahead journal of order events, kept as numbered segment files in one
+// directory next to the snapshots that let old segments be dropped:
+//   journal.<segment>   JournalFileHeader, then records back to back
+//   snapshot.<segment>  JournalFileHeader, then one OrderState record per
+//                       order; recovery loads it, then replays segments from
+//                       <segment> on
+// A record is a JournalRecordHeader plus its payload, padded to 8 bytes.
+// Segments are allocated at full size up front, so a zero length marks the
+// end; a bad checksum marks a record torn by a crash, and replay moves on to
+// the next segment.
+struct JournalFileHeader {
+    char magic[8];           // "ACJRNL\0\0" or "ACSNAP\0\0"
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t segment;
+    uint64_t records;        // snapshots only; segments are read to their end
+    uint64_t bytes;          // snapshots only
+    uint64_t padding[3];
+};
+
+struct JournalRecordHeader {
+    uint32_t length;         // payload bytes, before padding
+    uint16_t type;           // JournalRecordType
+    uint16_t reserved;
+    uint32_t handle;
+    uint32_t checksum;       // of the rest of the header and the payload
+    uint64_t sequence;       // per order, from 1; replay skips what it already has
+};
+
+static_assert(sizeof(JournalFileHeader) == 64);
+static_assert(sizeof(JournalRecordHeader) == 24);
+
+// 2: JournalFill carries filledChunks rather than the chunk index, and fills
+// and order states record the model's price-path steps. Files of any other
+// version are rejected on replay.
+constexpr uint32_t kJournalVersion = 2;
+
+enum class JournalRecordType : uint16_t {
+    Submit = 1,      // JournalSubmit, symbol, schedule
+    Status = 2,      // JournalStatus
+    Fill = 3,        // JournalFill
+    Reschedule = 4,  // JournalReschedule, schedule tail
+    OrderState = 5,  // JournalOrderState, symbol, schedule, FillRecord history
+};
+
+// Payloads are plain structs followed by their variable-length parts and are
+// read back with memcpy, so nothing in them needs to be aligned
+struct JournalSubmit {
+    int32_t totalShares;
+    uint8_t isBuy;
+    uint8_t jointSchedule;
+    uint16_t symbolLength;
+    double initialPrice;
+    double timeHorizon;
+    double riskAversion;
+    int32_t numIntervals;
+    uint32_t scheduleLength;
+};
+
+struct JournalStatus {
+    int32_t status;          // OrderStatus
+    uint32_t reserved;
+};
+
+struct JournalFill {
+    uint32_t filledChunks;   // schedule chunks done once this fill is applied
+    uint32_t modelSteps;     // price-path steps taken by simulated fills so far
+    double time;
+    double price;
+    double shares;
+};
+
+struct JournalReschedule {
+    uint32_t from;           // first replaced chunk
+    uint32_t count;
+};
+
+struct JournalOrderState {
+    JournalSubmit order;
+    int32_t status;          // OrderStatus
+    uint32_t filledChunks;
+    double executedShares;
+    double averageExecutionPrice;
+    uint32_t historyLength;
+    uint32_t modelSteps;
+};
+
+struct JournalRecord {
+    JournalRecordType type;
+    OrderHandle handle;
+    uint64_t sequence;
+    const char* payload;
+    size_t length;
+};
+
+struct JournalConfig {
+    std::string directory;               // empty disables journaling
+    size_t segmentBytes{64u << 20};
+    // Group commit: appends are copied into the shared mapping, which already
+    // survives a process crash; a flusher thread msyncs whatever accumulated
+    // once per interval, so no fill waits on the disk
+    std::chrono::microseconds commitInterval{2000};
+    // How often the flusher asks for a snapshot; 0 = only explicit checkpoints
+    std::chrono::seconds snapshotInterval{60};
+};
+
+struct JournalStats {
+    uint64_t records{0};
+    uint64_t bytes{0};
+    uint64_t commits{0};     // msync batches
+    uint64_t segments{0};    // opened by this process
+    uint64_t snapshots{0};
+};
+
+struct JournalReplayStats {
+    uint64_t snapshotSegment{0};    // 0 = no snapshot
+    uint64_t snapshotRecords{0};
+    uint64_t segmentRecords{0};
+    uint64_t segments{0};
+    uint64_t tornSegments{0};       // ended in a partial or corrupt record
+    uint64_t bytes{0};              // of records read
+};
+
+class order_journal {
+public:
+    // Records framed and checksummed ahead of time, appended as one unit
+    class batch {
+    public:
+        void add(JournalRecordType type, OrderHandle handle, uint64_t sequence,
+                 const void* payload, size_t length);
+        // Payload assembled from several parts, e.g. a header struct and arrays
+        void add(JournalRecordType type, OrderHandle handle, uint64_t sequence,
+                 std::initializer_list<std::pair<const void*, size_t>> parts);
+        void clear() { bytes_.clear(); records_ = 0; }
+        bool empty() const { return records_ == 0; }
+        size_t records() const { return records_; }
+        size_t bytes() const { return bytes_.size(); }
+
+    private:
+        friend class order_journal;
+        std::vector<char> bytes_;
+        size_t records_{0};
+    };
+
+    // Starts a new segment after any already in the directory; those are left
+    // for recovery until the next snapshot supersedes them
+    explicit order_journal(const JournalConfig& config);
+    ~order_journal(); // commits what is left
+
+    order_journal(const order_journal&) = delete;
+    order_journal& operator=(const order_journal&) = delete;
+
+    void append(const batch& records);
+    // Blocks until everything appended so far has been synced
+    void commit();
+
+    // Snapshots: beginSnapshot() moves appends to a new segment and returns
+    // its number; state captured after that, published by writeSnapshot(),
+    // plus segments from that number on is the whole history. Older segments
+    // and snapshots are deleted once the new snapshot is durable.
+    uint64_t beginSnapshot();
+    void writeSnapshot(uint64_t segment, const batch& state);
+
+    // Called from the flusher thread every snapshotInterval
+    void setSnapshotCallback(std::function<void()> callback);
+
+    JournalStats stats() const;
+    std::vector<NamedThread> threads(); // the flusher, "ac-journal"
+
+    // Feeds the newest snapshot and then every later segment to fn, in order
+    static JournalReplayStats replay(const std::string& directory,
+                                     const std::function<void(const JournalRecord&)>& fn);
+
+private:
+    struct Segment;
+
+    void openSegment_(uint64_t number, size_t minimumBytes); // mutex_ held
+    void flusherLoop_();
+    void syncPending_();
+
+    JournalConfig config_;
+    std::function<void()> snapshotCallback_;
+
+    mutable std::mutex mutex_;               // append position and segment switch
+    std::shared_ptr<Segment> current_;
+    std::vector<std::shared_ptr<Segment>> retired_; // rotated out, not yet fully synced
+    uint64_t nextSegment_{1};
+    uint64_t appended_{0};                   // bytes over every segment
+    uint64_t durable_{0};
+    JournalStats stats_;
+
+    std::mutex flushMutex_;                  // one sync at a time
+    std::condition_variable wake_;
+    std::condition_variable durableChanged_;
+    bool commitRequested_{false};
+    bool stopping_{false};
+    std::thread flusher_;
+};
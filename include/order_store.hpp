@@ -0,0 +1,187 @@
+#pragma once
+
+#include "latency_histogram.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Compact integer order handle; 0 is never allocated
+using OrderHandle = uint32_t;
+constexpr OrderHandle kInvalidOrderHandle = 0;
+
+// Order table split into independently locked shards. Handles are allocated
+// lock-free from an atomic counter and consecutive handles land in different
+// shards, so operations on unrelated orders rarely touch the same mutex.
+template <typename Value, size_t Shards = 64>
+class order_store {
+    static_assert((Shards & (Shards - 1)) == 0, "shard count must be a power of two");
+
+public:
+    OrderHandle allocate() {
+        return nextHandle_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Reserves count consecutive handles and returns the first
+    OrderHandle allocate(size_t count) {
+        return nextHandle_.fetch_add(static_cast<OrderHandle>(count), std::memory_order_relaxed);
+    }
+
+    // Moves allocation past handle, e.g. after restoring orders from a journal
+    void reserveThrough(OrderHandle handle) {
+        OrderHandle next = nextHandle_.load(std::memory_order_relaxed);
+        while (next <= handle && !nextHandle_.compare_exchange_weak(next, handle + 1, std::memory_order_relaxed)) {
+        }
+    }
+
+    void insert(OrderHandle handle, Value value) {
+        Shard& shard = shardFor_(handle);
+        auto lock = lock_(shard);
+        shard.values.insert_or_assign(handle, std::move(value));
+    }
+
+    // Bulk insert taking each shard's lock once
+    void insertBatch(std::vector<std::pair<OrderHandle, Value>>&& entries) {
+        forEachShardGroup_(entries, [](const auto& entry) { return entry.first; },
+                           [](Shard& shard, auto& entry) {
+                               shard.values.insert_or_assign(entry.first, std::move(entry.second));
+                           });
+    }
+
+    // Runs fn(handle, value) for each known handle, taking each shard's lock
+    // once; unknown handles are skipped. Visit order follows shards, not input.
+    template <typename Fn>
+    void withEach(const std::vector<OrderHandle>& handles, Fn&& fn) {
+        forEachShardGroup_(handles, [](OrderHandle handle) { return handle; },
+                           [&](Shard& shard, OrderHandle handle) {
+                               auto it = shard.values.find(handle);
+                               if (it != shard.values.end()) {
+                                   fn(handle, it->second);
+                               }
+                           });
+    }
+
+    // Runs fn(value) under the shard lock; false if the handle is unknown
+    template <typename Fn>
+    bool with(OrderHandle handle, Fn&& fn) {
+        Shard& shard = shardFor_(handle);
+        auto lock = lock_(shard);
+        auto it = shard.values.find(handle);
+        if (it == shard.values.end()) {
+            return false;
+        }
+        fn(it->second);
+        return true;
+    }
+
+    template <typename Fn>
+    bool with(OrderHandle handle, Fn&& fn) const {
+        const Shard& shard = shardFor_(handle);
+        auto lock = lock_(shard);
+        auto it = shard.values.find(handle);
+        if (it == shard.values.end()) {
+            return false;
+        }
+        fn(it->second);
+        return true;
+    }
+
+    // Visits every entry one shard at a time (no global snapshot)
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const Shard& shard : shards_) {
+            auto lock = lock_(shard);
+            for (const auto& [handle, value] : shard.values) {
+                fn(handle, value);
+            }
+        }
+    }
+
+    // Optional: time spent waiting for contended shard locks is recorded here.
+    // Uncontended acquisitions stay off the shared histogram; each shard only
+    // counts them, on its own cache line, under its own lock.
+    void setLockWaitHistogram(latency_histogram* histogram) { lockWait_ = histogram; }
+
+    // Shard lock acquisitions while a histogram is set, contended or not
+    uint64_t lockAcquisitions() const {
+        uint64_t total = 0;
+        for (const Shard& shard : shards_) {
+            total += shard.acquisitions.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    size_t size() const {
+        size_t total = 0;
+        for (const Shard& shard : shards_) {
+            auto lock = lock_(shard);
+            total += shard.values.size();
+        }
+        return total;
+    }
+
+private:
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        mutable std::atomic<uint64_t> acquisitions{0}; // written only under mutex
+        std::unordered_map<OrderHandle, Value> values;
+    };
+
+    std::unique_lock<std::mutex> lock_(const Shard& shard) const {
+        std::unique_lock lock(shard.mutex, std::try_to_lock);
+        if (lockWait_ != nullptr) {
+            if (!lock.owns_lock()) {
+                auto start = std::chrono::steady_clock::now();
+                lock.lock();
+                lockWait_->record(std::chrono::steady_clock::now() - start);
+            }
+            shard.acquisitions.store(shard.acquisitions.load(std::memory_order_relaxed) + 1,
+                                     std::memory_order_relaxed);
+        } else if (!lock.owns_lock()) {
+            lock.lock();
+        }
+        return lock;
+    }
+
+    static size_t shardIndex_(OrderHandle handle) { return handle & (Shards - 1); }
+
+    // Buckets items by shard (counting sort over indices, so items never move)
+    // and applies fn to each bucket with that shard locked
+    template <typename Items, typename KeyFn, typename Fn>
+    void forEachShardGroup_(Items& items, KeyFn key, Fn fn) {
+        std::array<size_t, Shards + 1> starts{};
+        for (const auto& item : items) {
+            ++starts[shardIndex_(key(item)) + 1];
+        }
+        for (size_t i = 0; i < Shards; ++i) {
+            starts[i + 1] += starts[i];
+        }
+        std::vector<size_t> order(items.size());
+        std::array<size_t, Shards> fill{};
+        for (size_t i = 0; i < items.size(); ++i) {
+            size_t index = shardIndex_(key(items[i]));
+            order[starts[index] + fill[index]++] = i;
+        }
+
+        for (size_t index = 0; index < Shards; ++index) {
+            if (starts[index] == starts[index + 1]) {
+                continue;
+            }
+            Shard& shard = shards_[index];
+            auto lock = lock_(shard);
+            for (size_t k = starts[index]; k < starts[index + 1]; ++k) {
+                fn(shard, items[order[k]]);
+            }
+        }
+    }
+
+    Shard& shardFor_(OrderHandle handle) { return shards_[handle & (Shards - 1)]; }
+    const Shard& shardFor_(OrderHandle handle) const { return shards_[handle & (Shards - 1)]; }
+
+    std::array<Shard, Shards> shards_;
+    std::atomic<OrderHandle> nextHandle_{1};
+    latency_histogram* lockWait_{nullptr};
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+// Counter-based generator: Philox4x32-10 (Salmon et al., "Parallel random
+// numbers: as easy as 1, 2, 3"). Block i of stream s is a pure function of
+// (key, s, i), so streams never overlap, skipping ahead is O(1) and a block
+// costs the same however far into the stream it is. Outputs match the
+// Random123 reference with counter {i lo, i hi, s lo, s hi} and key
+// {key lo, key hi}.
+//
+// Satisfies UniformRandomBitGenerator (two 64-bit outputs per block), but the
+// intended use is fillNormal, which turns whole blocks into normals in batches.
+class philox_rng {
+public:
+    using result_type = uint64_t;
+    using Block = std::array<uint32_t, 4>;
+
+    explicit philox_rng(uint64_t key = 0, uint64_t stream = 0) { seed(key, stream); }
+
+    // Restarts at block 0 of `stream` under `key`
+    void seed(uint64_t key, uint64_t stream = 0) {
+        key_ = key;
+        stream_ = stream;
+        block_ = 0;
+        half_ = 2;
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        if (half_ == 2) {
+            current_ = generate(block_++);
+            half_ = 0;
+        }
+        const uint32_t* words = current_.data() + 2 * half_++;
+        return uint64_t{words[0]} | (uint64_t{words[1]} << 32);
+    }
+
+    // Skips `outputs` 64-bit outputs
+    void discard(uint64_t outputs) {
+        uint64_t target = position() + outputs;
+        seek(target / 2);
+        if (target % 2 != 0) {
+            (*this)();
+        }
+    }
+
+    // Next block to be generated; a half-used block counts as used
+    uint64_t block() const { return block_; }
+    void seek(uint64_t block) {
+        block_ = block;
+        half_ = 2;
+    }
+
+    uint64_t key() const { return key_; }
+    uint64_t stream() const { return stream_; }
+
+    Block generate(uint64_t block) const;
+
+    // Standard normals from consecutive whole blocks, two per block (Box-Muller
+    // on the block's two 64-bit halves): out[2j] and out[2j + 1] come from
+    // block() + j. An odd-sized request still consumes its last block. Draws
+    // depend only on (key, stream, block), so splitting a request into
+    // even-sized pieces, on any thread, gives the same numbers.
+    void fillNormal(std::span<double> out);
+
+private:
+    uint64_t position() const { return 2 * block_ - (2 - half_); }
+
+    uint64_t key_{0};
+    uint64_t stream_{0};
+    uint64_t block_{0};
+    uint32_t half_{2};   // outputs of current_ already handed out
+    Block current_{};
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "dense_linalg.hpp"
+#include "trajectory_kernel.hpp"
+#include <cstddef>
+#include <vector>
+
+// Joint Almgren-Chriss liquidation of a basket: mean-variance objective with
+// covariance C and linear temporary impact H (both n x n). With H = L L^T,
+// y = L^T x turns the Euler-Lagrange equations H x'' = λ C x into independent
+// modes of A = λ L^{-1} C L^{-T} = U diag(κ_j²) U^T, each following the
+// single-asset trajectory with its own κ_j:
+//   x(t) = L^{-T} U f(t) U^T L^T x0,   f_j(t) = sinh(κ_j(T-t)) / sinh(κ_j T)
+// For one asset this is AlmgrenChrissModel's κ = sqrt(λσ²/η).
+class PortfolioLiquidationModel {
+public:
+    // threads == 0 uses every hardware thread for the factorizations
+    explicit PortfolioLiquidationModel(unsigned threads = 0);
+
+    // covariance and impact are n x n row-major and symmetric; impact must be
+    // positive definite (a diagonal impact skips the Cholesky). Negative
+    // covariance eigenvalues are treated as zero risk. positions are signed
+    // shares to trade, buys positive. O(n^3): factorizes and decomposes.
+    void setParameters(const std::vector<double>& covariance, const std::vector<double>& impact,
+                       double lambda, const std::vector<double>& positions, double timeHorizon);
+    // New positions for the same basket. O(n^2)
+    void setPositions(const std::vector<double>& positions);
+
+    size_t assets() const { return assets_; }
+    double getLambda() const { return lambda_; }
+    double getTimeHorizon() const { return timeHorizon_; }
+    const std::vector<double>& modeKappas() const { return kappas_; }
+
+    // Signed holdings still to trade at t (clamped to [0, T])
+    std::vector<double> holdingsAt(double t) const;
+    // intervals x assets, row-major: signed shares traded in each interval,
+    // x(t_k) - x(t_{k+1}). Rows sum to the positions.
+    std::vector<double> calculateOptimalSchedule(int intervals) const;
+    // The same for other positions in this basket, leaving the model's own
+    // untouched, so one factorized model can serve concurrent callers. O(n^2)
+    // on top of the schedule.
+    std::vector<double> calculateOptimalSchedule(const std::vector<double>& positions, int intervals) const;
+
+private:
+    double modeFraction_(size_t mode, double t) const;
+    std::vector<double> modeWeightsFor_(const std::vector<double>& positions) const;
+    std::vector<double> schedule_(const std::vector<double>& modeWeights, int intervals) const;
+
+    unsigned threads_;
+    size_t assets_{0};
+    double lambda_{0.0};
+    double timeHorizon_{0.0};
+    dense_matrix lower_;                   // L, with H = L L^T
+    dense_matrix eigenvectorRows_;         // U^T
+    dense_matrix modeHoldings_;            // row j: (L^{-T} u_j)^T, holdings per unit of mode j
+    std::vector<double> kappas_;
+    std::vector<trajectory::Params> modes_;
+    std::vector<double> modeWeights_;      // U^T L^T x0
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "market_data.hpp"
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <memory>
+
+// Latest quote per symbol in a preallocated array of seqlock slots. Publishing
+// never blocks or allocates; readers retry only if they overlap a write and
+// never block the writer. publish() and version() take ids below capacity()
+// only; callers holding ids from outside check them first.
+class quote_board {
+public:
+    explicit quote_board(size_t capacity = 4096)
+        : capacity_(capacity), slots_(new Slot[capacity]) {}
+
+    void publish(SymbolId id, const MarketQuote& quote) {
+        assert(id < capacity_);
+        Slot& slot = slots_[id];
+        std::array<uint64_t, kWords> words;
+        std::memcpy(words.data(), &quote, sizeof(quote));
+
+        // Odd sequence = write in progress. CAS so concurrent writers to one symbol serialize.
+        uint32_t seq = slot.sequence.load(std::memory_order_relaxed);
+        while ((seq & 1) || !slot.sequence.compare_exchange_weak(seq, seq + 1, std::memory_order_relaxed)) {
+            seq = slot.sequence.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; ++i) {
+            slot.words[i].store(words[i], std::memory_order_relaxed);
+        }
+        slot.sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    // false if nothing has been published for the symbol yet
+    bool read(SymbolId id, MarketQuote& out) const {
+        if (id >= capacity_) {
+            return false;
+        }
+        const Slot& slot = slots_[id];
+        std::array<uint64_t, kWords> words;
+        uint32_t before;
+        uint32_t after;
+        do {
+            before = slot.sequence.load(std::memory_order_acquire);
+            for (size_t i = 0; i < kWords; ++i) {
+                words[i] = slot.words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = slot.sequence.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+
+        if (before == 0) {
+            return false;
+        }
+        std::memcpy(&out, words.data(), sizeof(out));
+        return true;
+    }
+
+    // Bumped on every publish; lets consumers detect new ticks cheaply
+    uint32_t version(SymbolId id) const {
+        assert(id < capacity_);
+        return slots_[id].sequence.load(std::memory_order_acquire) >> 1;
+    }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    static constexpr size_t kWords = sizeof(MarketQuote) / sizeof(uint64_t);
+
+    struct alignas(64) Slot {
+        std::atomic<uint32_t> sequence{0};
+        std::array<std::atomic<uint64_t>, kWords> words{};
+    };
+
+    size_t capacity_;
+    std::unique_ptr<Slot[]> slots_;
+};
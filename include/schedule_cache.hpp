@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// An Almgren-Chriss trajectory depends on sigma, eta and lambda only through
+// kappa, and scales linearly with order size, so the key is (kappa, T, intervals)
+// compared bit for bit
+struct ScheduleKey {
+    double kappa{0.0};
+    double timeHorizon{0.0};
+    int intervals{0};
+
+    bool operator==(const ScheduleKey& other) const;
+};
+
+struct ScheduleCacheStats {
+    uint64_t hits{0};
+    uint64_t misses{0};
+    uint64_t evictions{0};
+    size_t size{0};
+    size_t capacity{0};
+
+    double hitRate() const {
+        uint64_t lookups = hits + misses;
+        return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+    }
+};
+
+// Bounded, thread-safe cache of normalized schedule shapes (per-interval
+// fractions summing to 1). Entries are spread over independently locked
+// shards, each evicting least recently used first. Shapes are immutable and
+// shared, so a hit costs one shard lock and a refcount bump; misses compute
+// outside the lock, and two threads missing the same key both compute it.
+class schedule_cache {
+public:
+    using Shape = std::shared_ptr<const std::vector<double>>;
+    using Compute = std::function<std::vector<double>()>;
+
+    explicit schedule_cache(size_t capacity = 1024); // 0 disables caching
+
+    Shape shape(const ScheduleKey& key, const Compute& compute);
+    // shape(key) scaled by totalShares
+    std::vector<double> schedule(const ScheduleKey& key, double totalShares, const Compute& compute);
+
+    ScheduleCacheStats stats() const;
+    void clear();
+
+private:
+    static constexpr size_t kShards = 16;
+
+    struct KeyHash {
+        size_t operator()(const ScheduleKey& key) const;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list<std::pair<ScheduleKey, Shape>> entries; // most recently used first
+        std::unordered_map<ScheduleKey, decltype(entries)::iterator, KeyHash> index;
+    };
+
+    Shard& shardFor_(const ScheduleKey& key) { return shards_[KeyHash{}(key) % kShards]; }
+
+    size_t capacity_;
+    size_t shardCapacity_;
+    std::array<Shard, kShards> shards_;
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> evictions_{0};
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Time source for execution_scheduler. The real clock is steady_clock; the
+// simulated clock only moves when the scheduler jumps it to the next event.
+class scheduler_clock {
+public:
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    virtual ~scheduler_clock() = default;
+    virtual TimePoint now() const = 0;
+    virtual bool isSimulated() const { return false; }
+};
+
+class real_clock : public scheduler_clock {
+public:
+    TimePoint now() const override { return std::chrono::steady_clock::now(); }
+};
+
+class simulated_clock : public scheduler_clock {
+public:
+    explicit simulated_clock(TimePoint start = TimePoint{})
+        : nanos_(std::chrono::duration_cast<std::chrono::nanoseconds>(start.time_since_epoch()).count()) {}
+
+    TimePoint now() const override {
+        return TimePoint(std::chrono::duration_cast<TimePoint::duration>(
+            std::chrono::nanoseconds(nanos_.load(std::memory_order_acquire))));
+    }
+    bool isSimulated() const override { return true; }
+
+    // Never moves backwards
+    void advanceTo(TimePoint time) {
+        int64_t target = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+        int64_t current = nanos_.load(std::memory_order_relaxed);
+        while (current < target && !nanos_.compare_exchange_weak(current, target, std::memory_order_release)) {
+        }
+    }
+    void advanceBy(std::chrono::nanoseconds delta) { advanceTo(now() + delta); }
+
+private:
+    std::atomic<int64_t> nanos_;
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "market_data.hpp"
+#include "quote_board.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+struct BookConfig {
+    // Levels synthesized per side from each quote; 0 turns the book off and
+    // chunks fill whole at the model price as before
+    size_t depth{10};
+    double tickSize{0.01};
+    // Displayed size at level k is the quoted top size times growth^k
+    double depthGrowth{1.2};
+    // Liquidity taken from a level comes back linearly over this long, or all
+    // at once with the next quote for the symbol
+    std::chrono::milliseconds recovery{1000};
+};
+
+// Result of walking one side of a book
+struct BookFill {
+    double shares{0.0};      // filled; less than asked once the levels run out
+    double notional{0.0};
+    double lastPrice{0.0};   // deepest level touched
+    uint32_t levels{0};
+
+    double averagePrice() const { return shares > 0.0 ? notional / shares : 0.0; }
+};
+
+struct BookStats {
+    uint64_t rebuilds{0};
+    uint64_t takes{0};
+    uint64_t partialTakes{0};  // ran out of levels before the size asked for
+    uint64_t levels{0};        // levels touched over all takes
+};
+
+// Simulated L2 book per symbol, synthesized from the top-of-book quotes on a
+// quote_board. Each book is one flat block of per-level sizes, preallocated
+// and indexed by SymbolId; prices are implied by the touch and the tick, so
+// walking a side is a scan over one contiguous array.
+//
+// A book is rebuilt lazily when take() sees a newer quote than the one it was
+// built from. Books are not locked: all calls for one symbol must come from
+// one thread at a time (the engine only takes from a book in tasks with that
+// symbol's affinity). stats() may be called from any thread.
+class simulated_book {
+public:
+    static constexpr size_t kMaxDepth = 16;
+
+    simulated_book(const quote_board& quotes, const BookConfig& config);
+
+    // Buys walk the asks up from the best ask, sells the bids down. nullopt if
+    // the symbol has no usable quote on that side (none yet, zero size,
+    // crossed), so the caller can fall back to its own price.
+    std::optional<BookFill> take(SymbolId symbol, bool isBuy, double shares, int64_t nowNs);
+
+    bool enabled() const { return depth_ > 0; }
+    size_t depth() const { return depth_; }
+    BookStats stats() const;
+
+private:
+    struct alignas(64) Book {
+        uint32_t version{0};          // quote_board version the levels were built from
+        bool valid{false};
+        double bestBid{0.0};
+        double bestAsk{0.0};
+        double topBidSize{0.0};
+        double topAskSize{0.0};
+        int64_t updatedNs{0};         // last rebuild or take, for recovery
+        std::array<double, kMaxDepth> bidLeft{};
+        std::array<double, kMaxDepth> askLeft{};
+
+        // Single writer; relaxed atomics so stats() can read them
+        std::atomic<uint64_t> rebuilds{0};
+        std::atomic<uint64_t> takes{0};
+        std::atomic<uint64_t> partialTakes{0};
+        std::atomic<uint64_t> levels{0};
+    };
+
+    void sync_(SymbolId symbol, Book& book, int64_t nowNs);
+    void replenish_(Book& book, int64_t nowNs) const;
+
+    const quote_board& quotes_;
+    size_t depth_;
+    double tickSize_;
+    int64_t recoveryNs_;
+    std::array<double, kMaxDepth> growth_{}; // depthGrowth^k
+    std::unique_ptr<Book[]> books_;          // one per quote_board slot
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "market_data.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Interns symbol strings to dense SymbolIds. Capacity is fixed at construction
+// so lookups of known symbols are lock-free and allocation-free; only the first
+// sighting of a new symbol takes the mutex.
+class symbol_table {
+public:
+    explicit symbol_table(size_t capacity = 4096);
+
+    // Returns kInvalidSymbol if the symbol was never interned
+    SymbolId find(std::string_view symbol) const;
+    // Throws std::length_error once capacity is exhausted
+    SymbolId intern(std::string_view symbol);
+
+    const std::string& name(SymbolId id) const;
+    size_t size() const { return size_.load(std::memory_order_acquire); }
+    size_t capacity() const { return capacity_; }
+
+private:
+    static uint64_t hash_(std::string_view symbol);
+    SymbolId probe_(std::string_view symbol, uint64_t hash, size_t& emptySlot) const;
+
+    size_t capacity_;
+    size_t mask_;
+    std::unique_ptr<std::atomic<uint32_t>[]> slots_;          // id + 1, 0 = empty
+    std::unique_ptr<std::atomic<const std::string*>[]> names_; // indexed by id
+    std::vector<std::unique_ptr<std::string>> storage_;       // owned strings, touched under mutex_
+    std::atomic<uint32_t> size_{0};
+    std::mutex mutex_;
+};
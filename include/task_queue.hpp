@@ -0,0 +1,82 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+
+// Shared between queue entries and the TaskHandle given to the caller.
+// Mutated only under the scheduler's queue mutex; `token` is atomic so a
+// handle can be polled without locking.
+struct TaskState {
+    static constexpr uint64_t kDispatched = ~uint64_t{0};
+    static constexpr uint64_t kCancelled = kDispatched - 1;
+
+    std::function<void()> task;
+    std::chrono::nanoseconds interval{0};
+    uint64_t affinity{0};
+    std::atomic<uint64_t> token{0}; // generation of the live queue entry, or a terminal marker
+    uint64_t nextGeneration{1};
+    bool stopRequested{false};      // recurring tasks: don't re-arm after the current run
+};
+
+// represents a scheduled task with execution time and the task itself.
+// Cancel/reschedule bump the state's token, so older entries go stale and
+// are dropped lazily when they reach the front of the queue.
+struct ScheduledTask {
+    using Task = std::function<void()>;
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    TimePoint executionTime;
+    std::shared_ptr<TaskState> state;
+    uint64_t generation{0};
+    std::chrono::nanoseconds interval{0}; // for recurring tasks
+    uint64_t affinity{0}; // tasks sharing a non-zero key run in order on one worker
+    bool isRecurring() const {
+        return interval.count() > 0;
+    }
+    bool isLive() const {
+        return state && state->token.load(std::memory_order_relaxed) == generation;
+    }
+
+    // (earlier time has higher priority)
+    bool operator<(const ScheduledTask& other) const {
+        return executionTime > other.executionTime; // Min-heap behaviour
+    }
+};
+
+// Storage backend for execution_scheduler. Not thread-safe; the scheduler
+// serializes access under its own queue mutex.
+class task_queue {
+public:
+    using TimePoint = ScheduledTask::TimePoint;
+
+    virtual ~task_queue() = default;
+
+    virtual void push(ScheduledTask task) = 0;
+    // Moves every task due at or before `now` into `out`
+    virtual void popDue(TimePoint now, std::vector<ScheduledTask>& out) = 0;
+    // Earliest time the queue needs servicing; only meaningful when not empty
+    virtual TimePoint nextDeadline() const = 0;
+    virtual size_t size() const = 0;
+    // Removes every stale entry (cancelled or superseded); returns how many
+    virtual size_t purgeStale() = 0;
+
+    bool empty() const { return size() == 0; }
+};
+
+// O(log n) push/pop, exact ordering by execution time
+class binary_heap_queue : public task_queue {
+public:
+    void push(ScheduledTask task) override;
+    void popDue(TimePoint now, std::vector<ScheduledTask>& out) override;
+    TimePoint nextDeadline() const override;
+    size_t size() const override { return heap_.size(); }
+    size_t purgeStale() override;
+
+private:
+    std::vector<ScheduledTask> heap_;
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <thread>
+#include <vector>
+
+// A running thread owned by one of the engine's components
+struct NamedThread {
+    std::string name;
+    std::thread::native_handle_type handle;
+};
+
+// Where and how one thread should run
+struct ThreadPlacement {
+    std::vector<int> cpus;   // affinity mask; empty = leave it alone
+    int fifoPriority{0};     // 1-99 = SCHED_FIFO at that priority; 0 = leave the policy alone
+};
+
+// What was asked of a thread and what the OS let us do
+struct ThreadReport {
+    std::string name;
+    ThreadPlacement requested;
+    bool named{false};
+    bool pinned{false};
+    bool realtime{false};
+    std::string error;       // the first request that was refused, and why
+
+    std::string describe() const;
+};
+
+// Naming, pinning and SCHED_FIFO for threads that are already running.
+// Linux only; elsewhere every request is reported as unsupported.
+namespace thread_tuning {
+
+// The kernel keeps the first 15 characters of a name
+bool setName(std::thread::native_handle_type thread, const std::string& name);
+
+// Never throws: refusals (EPERM without CAP_SYS_NICE, CPUs outside the
+// cgroup, ...) end up in the report instead
+ThreadReport apply(const NamedThread& thread, const ThreadPlacement& placement);
+
+// "2,4-6" -> {2, 4, 5, 6}; throws std::invalid_argument on anything else
+std::vector<int> parseCpuList(const std::string& text);
+std::string formatCpuList(const std::vector<int>& cpus);
+
+} // namespace thread_tuning
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "market_data.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Binary tick file layout (little-endian, native struct layout):
+//   TickFileHeader | TickRecord[tickCount] | TickSymbolName[symbolCount]
+// The symbol table is a trailer so the writer can stream ticks without
+// knowing the symbol universe up front.
+struct TickFileHeader {
+    char magic[8];               // "ACTICK\0\0"
+    uint32_t version;
+    uint32_t symbolCount;
+    uint64_t tickCount;
+    uint64_t symbolTableOffset;
+    uint64_t firstTimestampNs;
+    uint64_t lastTimestampNs;
+    uint64_t reserved[2];
+};
+
+struct TickRecord {
+    MarketQuote quote;
+    uint32_t symbol;             // index into the file's symbol table
+    uint32_t reserved;
+};
+
+struct TickSymbolName {
+    char name[32];               // NUL-padded
+};
+
+static_assert(sizeof(TickFileHeader) == 64);
+static_assert(sizeof(TickRecord) == sizeof(MarketQuote) + 8);
+
+constexpr uint32_t kTickFileVersion = 1;
+
+class TickFileWriter {
+public:
+    explicit TickFileWriter(const std::string& path);
+    ~TickFileWriter();
+
+    TickFileWriter(const TickFileWriter&) = delete;
+    TickFileWriter& operator=(const TickFileWriter&) = delete;
+
+    void write(const std::string& symbol, const MarketQuote& quote);
+    // Writes the symbol table and final header; called by the destructor if needed
+    void finish();
+
+    uint64_t tickCount() const { return header_.tickCount; }
+
+private:
+    std::FILE* file_{nullptr};
+    TickFileHeader header_{};
+    std::unordered_map<std::string, uint32_t> symbolIndex_;
+    std::vector<std::string> symbols_;
+    bool finished_{false};
+};
+
+// Read-only memory map of a tick file. Pages are faulted in on demand, so
+// multi-GB files replay without being loaded into RAM.
+class MappedTickFile {
+public:
+    explicit MappedTickFile(const std::string& path);
+    ~MappedTickFile();
+
+    MappedTickFile(const MappedTickFile&) = delete;
+    MappedTickFile& operator=(const MappedTickFile&) = delete;
+
+    const TickFileHeader& header() const { return *header_; }
+    const TickRecord* begin() const { return ticks_; }
+    const TickRecord* end() const { return ticks_ + header_->tickCount; }
+    size_t size() const { return header_->tickCount; }
+    std::string symbol(uint32_t index) const;
+    uint32_t symbolCount() const { return header_->symbolCount; }
+
+    // Lets the kernel drop already-replayed pages before [record]
+    void release(const TickRecord* upTo) const;
+
+private:
+    int fd_{-1};
+    void* data_{nullptr};
+    size_t length_{0};
+    const TickFileHeader* header_{nullptr};
+    const TickRecord* ticks_{nullptr};
+    const TickSymbolName* names_{nullptr};
+};
+
+// CSV columns: timestamp_ns,symbol,bid,ask,bid_size,ask_size,last,volume
+// A first line starting with a non-digit is treated as a header. Returns ticks written.
+uint64_t convertCsvToTickFile(const std::string& csvPath, const std::string& tickPath);
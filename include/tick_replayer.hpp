@@ -0,0 +1,41 @@
+#pragma once
+
+#include "tick_file.hpp"
+#include <cstdint>
+
+class TradingEngine;
+
+enum class ReplaySpeed {
+    RealTime, // original inter-tick spacing
+    Scaled,   // spacing divided by ReplayOptions::speedFactor
+    Maximum   // no pacing
+};
+
+struct ReplayOptions {
+    ReplaySpeed speed{ReplaySpeed::Maximum};
+    double speedFactor{1.0};
+    // Drop replayed pages from memory every this many bytes (0 = leave to the kernel)
+    size_t releaseEveryBytes{64u << 20};
+};
+
+struct ReplayStats {
+    uint64_t ticks{0};
+    double wallSeconds{0.0};
+    double dataSeconds{0.0};    // span covered by the replayed timestamps
+    double ticksPerSecond{0.0};
+};
+
+// Feeds a mapped tick file into TradingEngine::onMarketDataUpdate. Records
+// are passed by reference straight out of the mapping; the only per-tick
+// work is one symbol-id translation.
+class TickReplayer {
+public:
+    explicit TickReplayer(TradingEngine& engine) : engine_(engine) {}
+
+    // Throws std::runtime_error at the first record whose symbol index is
+    // outside the file's symbol table; ticks before it have been delivered
+    ReplayStats replay(const MappedTickFile& file, const ReplayOptions& options = {});
+
+private:
+    TradingEngine& engine_;
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "task_queue.hpp"
+#include <array>
+#include <cstdint>
+
+// Hierarchical timing wheel: 4 levels x 64 slots with an occupancy bitmap per
+// level. Insert is O(1); expiry is O(1) amortized (each task cascades at most
+// once per level). Deadlines are rounded up to the tick, so tasks never fire
+// early but may fire up to one tick late. Horizons beyond 64^4 ticks go to an
+// overflow list that is re-examined as time advances.
+class timing_wheel_queue : public task_queue {
+public:
+    explicit timing_wheel_queue(std::chrono::nanoseconds tick = std::chrono::milliseconds(1),
+                                TimePoint origin = std::chrono::steady_clock::now());
+
+    void push(ScheduledTask task) override;
+    void popDue(TimePoint now, std::vector<ScheduledTask>& out) override;
+    TimePoint nextDeadline() const override;
+    size_t size() const override { return size_; }
+    size_t purgeStale() override;
+
+    std::chrono::nanoseconds tick() const { return tick_; }
+
+private:
+    static constexpr int kLevels = 4;
+    static constexpr int kSlotBits = 6;
+    static constexpr uint64_t kSlots = uint64_t{1} << kSlotBits;
+    static constexpr uint64_t kSlotMask = kSlots - 1;
+    static constexpr uint64_t kSpan = uint64_t{1} << (kSlotBits * kLevels); // ticks covered by the wheel
+
+    struct Entry {
+        uint64_t tick;
+        ScheduledTask task;
+    };
+
+    uint64_t ceilTick_(TimePoint time) const;
+    uint64_t floorTick_(TimePoint time) const;
+    TimePoint timeOf_(uint64_t tick) const;
+
+    void place_(Entry&& entry);
+    uint64_t nextEventTick_() const; // UINT64_MAX when nothing is stored
+    void processTick_(uint64_t tick, std::vector<ScheduledTask>& out);
+    void drainReady_(std::vector<ScheduledTask>& out);
+
+    std::chrono::nanoseconds tick_;
+    TimePoint origin_;
+    uint64_t current_{0};
+    size_t size_{0};
+
+    std::array<std::array<std::vector<Entry>, kSlots>, kLevels> slots_;
+    std::array<uint64_t, kLevels> occupied_{};
+    std::vector<Entry> ready_;    // due at or before current_
+    std::vector<Entry> overflow_; // beyond the wheel span
+    std::vector<Entry> scratch_;  // reused while cascading
+};
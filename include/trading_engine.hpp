@@ -2,12 +2,90 @@
 
 #include "execution_scheduler.hpp"
 #include "market_impact_model.hpp"
+#include "monte_carlo_simulator.hpp"
 #include "market_data.hpp"
 #include "execution_metrics.hpp"
+#include "order_store.hpp"
+#include "symbol_table.hpp"
+#include "quote_board.hpp"
+#include "event_dispatcher.hpp"
+#include "latency_histogram.hpp"
+#include "schedule_cache.hpp"
+#include "portfolio_model.hpp"
+#include "order_journal.hpp"
+#include "simulated_book.hpp"
+#include "thread_tuning.hpp"
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
 #include <vector>
 #include <map>
 
+enum class ChunkTrigger {
+    Timer,       // each chunk fires when its interval is up
+    MarketData,  // a tick on the symbol can fire it early; the timer is only a deadline
+};
+
+struct EngineConfig {
+    SchedulerConfig scheduler;
+    size_t maxSymbols{4096}; // fixed so the market data path never reallocates
+    // When set, each order's model is seeded from this and its handle, making
+    // simulated-clock runs reproducible
+    std::optional<uint64_t> modelSeed;
+    // A symbol's live orders are re-planned when its estimated volatility or
+    // relative spread moves this far from what their schedule assumed. Ticks
+    // are coalesced so each symbol recomputes at most once per window.
+    double reoptimizeThreshold{0.25};
+    std::chrono::milliseconds marketDataCoalesce{50};
+    // Callbacks are delivered from a dispatcher thread in batches; with a
+    // simulated clock they are always delivered inline, like the scheduler
+    DispatcherConfig dispatcher;
+    // Normalized schedule shapes shared by orders with the same kappa, horizon
+    // and interval count; 0 disables the cache
+    size_t scheduleCacheCapacity{1024};
+    // When journal.directory is set, submits, status changes, fills and
+    // re-plans are journaled there, and the constructor first rebuilds the
+    // order table from it and reschedules the remaining chunks of active orders
+    JournalConfig journal;
+    // Chunks fill against a book synthesized from each symbol's quotes,
+    // walking price levels; whatever the book can't fill is carried into the
+    // next chunk. Symbols without a quote fill at the model price.
+    BookConfig book;
+    // MarketData: once the last releaseWindow (fraction) of a chunk's interval
+    // begins, the first tick on the symbol quoting size on the side the order
+    // takes from fires the chunk at once. Orders on quiet symbols only wake
+    // at their deadlines.
+    ChunkTrigger chunkTrigger{ChunkTrigger::Timer};
+    double releaseWindow{0.5};
+};
+
+// What the constructor rebuilt from EngineConfig::journal
+struct RecoveryStats {
+    JournalReplayStats replay;
+    size_t orders{0};
+    size_t rescheduled{0};       // active orders whose next chunk was queued again
+    uint64_t skippedRecords{0};  // already in the snapshot, or for an unknown order
+    std::chrono::microseconds elapsed{0};
+};
+
+struct EngineStats {
+    LatencySummary dispatchLag;  // scheduled task start vs its deadline
+    LatencySummary taskRunTime;  // scheduled task body, wall clock
+    LatencySummary lockWait;     // order table shard locks, contended acquisitions only
+    uint64_t lockAcquisitions{0}; // all order table shard lock acquisitions
+    LatencySummary callbackTime; // each user callback, on the dispatcher thread
+    DispatchStats dispatch;
+    ScheduleCacheStats scheduleCache;
+    JournalStats journal;
+    RecoveryStats recovery;
+    BookStats book;
+    size_t pendingTasks{0};
+    uint64_t scheduleAdjustments{0};
+    uint64_t releasedChunks{0};  // fired ahead of their deadline by market data
+};
+
 class TradingEngine {
 public:
     using ExecutionCallback = std::function<void(const std::string& orderId,
@@ -19,12 +97,22 @@ public:
     
     using StatusCallback = std::function<void(const std::string& orderId, OrderStatus status)>;
     using ProgressCallback = std::function<void(const std::string& orderId, double progressPercent)>;
+    // Wraps the delivery of each batch of callbacks, e.g. to take a lock once
+    using CallbackScope = std::function<void(const std::function<void()>& deliver)>;
 
     TradingEngine();
+    explicit TradingEngine(const EngineConfig& config);
     ~TradingEngine();
 
+    // Names every engine thread and, given a config file, pins them and sets
+    // SCHED_FIFO (see readThreadConfig in trading_engine.cpp for the format).
+    // What was actually applied is logged and kept for threadReport().
     void initialize(const std::string& configPath = "");
+    std::vector<ThreadReport> threadReport() const;
     void shutdown();
+    // Snapshots every order so recovery can skip the journal written so far;
+    // also run every JournalConfig::snapshotInterval. No-op without a journal.
+    void checkpoint();
 
     struct Order {
         std::string symbol;
@@ -37,20 +125,77 @@ public:
         int numIntervals{10};
     };
 
+    // Legs traded on one joint plan (see PortfolioLiquidationModel). Each leg
+    // supplies symbol, side, size and price; horizon, risk aversion and
+    // interval count come from the basket. covariance and impact are
+    // legs x legs, row-major, in the same units as the single-order model.
+    struct BasketOrder {
+        std::vector<Order> legs;
+        std::vector<double> covariance;
+        std::vector<double> impact;
+        double riskAversion{1.0};
+        double timeHorizon{60.0};
+        int numIntervals{10};
+    };
+
+    // Orders are keyed by compact integer handles; the "ORDER_<n>" strings are
+    // only a display mapping (n is the handle) kept for the Python layer
+    static OrderHandle handleOf(const std::string& orderId);
+    static std::string orderIdOf(OrderHandle handle);
+
     std::string submitOrder(const Order& order);
+    // Basket entry points: the whole batch is validated up front (nothing is
+    // submitted if any order is invalid), models and schedules are built in
+    // parallel, and each shard of the order table is locked once
+    std::vector<std::string> submitOrders(const std::vector<Order>& orders);
+    // One order per leg, in leg order. The decomposition is kept and reused
+    // while covariance, impact, risk aversion and horizon don't change.
+    // Legs keep their joint schedule: market data doesn't re-plan them.
+    std::vector<std::string> submitBasket(const BasketOrder& basket);
+    void startExecutions(const std::vector<std::string>& orderIds);
+    void startExecutions(const std::vector<OrderHandle>& handles);
     void cancelOrder(const std::string& orderId);
+    void cancelOrder(OrderHandle handle);
     OrderStatus getOrderStatus(const std::string& orderId) const;
+    OrderStatus getOrderStatus(OrderHandle handle) const;
 
     void startExecution(const std::string& orderId);
+    void startExecution(OrderHandle handle);
     void pauseExecution(const std::string& orderId);
+    void pauseExecution(OrderHandle handle);
     void resumeExecution(const std::string& orderId);
+    void resumeExecution(OrderHandle handle);
 
+    // Feed handlers should intern once and publish by id: that path takes no
+    // locks and does no allocation. The MarketData overload interns on the fly.
+    // An id beyond maxSymbols throws std::out_of_range.
+    SymbolId internSymbol(const std::string& symbol);
     void onMarketDataUpdate(const MarketData& data);
+    void onMarketDataUpdate(SymbolId symbol, const MarketQuote& quote);
+    bool getMarketQuote(SymbolId symbol, MarketQuote& out) const;
+    std::optional<MarketData> getMarketData(const std::string& symbol) const;
+    // Applies a fill from the venue to its order; simulated chunk fills take
+    // the same path. Reports for unknown orders are ignored.
     void onExecutionReport(const ExecutionReport& report);
+    void onExecutionReport(OrderHandle handle, double shares, double price);
 
     std::vector<Order> getActiveOrder() const;
     ExecutionMetrics getOrderMetrics(const std::string& orderId) const;
+    ExecutionMetrics getOrderMetrics(OrderHandle handle) const;
     std::vector<double> getRemainingSchedule(const std::string& orderId) const;
+    std::vector<double> getRemainingSchedule(OrderHandle handle) const;
+    std::vector<FillRecord> getExecutionHistory(const std::string& orderId) const;
+    std::vector<FillRecord> getExecutionHistory(OrderHandle handle) const;
+    std::vector<OrderMetricsRow> getAllOrderMetrics() const; // one pass over every shard
+    MonteCarloResult simulateExecutionCost(const std::string& orderId, size_t paths, uint64_t seed = 0) const;
+
+    // Discrete-event mode (EngineConfig::scheduler.clock is a simulated_clock):
+    // drive every scheduled chunk on the calling thread, jumping time between events
+    size_t runSimulation() { return scheduler_.runUntilIdle(); }
+    size_t runSimulationUntil(std::chrono::steady_clock::time_point limit) { return scheduler_.runUntil(limit); }
+    std::chrono::steady_clock::time_point now() const { return scheduler_.now(); }
+    bool isSimulated() const { return scheduler_.isSimulated(); }
+    uint64_t scheduleAdjustments() const { return scheduleAdjustments_.load(std::memory_order_relaxed); }
     int calculateOptimalIntervalCount_(int totalShares);
 
     void setExecutionCallback(ExecutionCallback callback){
@@ -62,18 +207,48 @@ public:
     void setProgressCallback(ProgressCallback callback) { 
         progressCallback_ = callback;
     }
+    void setCallbackScope(CallbackScope scope) {
+        callbackScope_ = std::move(scope);
+    }
+    DispatchStats dispatchStats() const { return dispatcher_.stats(); }
+    EngineStats stats() const;
+    void flushEvents() { dispatcher_.flush(); }
 
 private:
     struct OrderExecutionContext{
+        OrderHandle handle{kInvalidOrderHandle};
+        SymbolId symbolId{kInvalidSymbol};
         Order order;
         AlmgrenChrissModel model;
         
         std::vector<double> optimalSchedule;
+        bool jointSchedule{false}; // planned with the rest of its basket
         size_t currentScheduleIndex{0};
+        size_t filledChunks{0};        // where recovery picks the schedule up again
+        uint32_t modelSteps{0};        // simulated fills, each one step of the model's price path
+        uint64_t journalSequence{0};   // of the order's last journal record
         double executedShares{0.0};
         double averageExecutionPrice{0.0};
-        std::vector<std::pair<double, double>> executionHistory; // time, price
+        std::vector<FillRecord> executionHistory;
         OrderStatus status{OrderStatus::PENDING};
+        TaskHandle pendingChunk; // queued chunk task, cancelled on cancel/pause
+        std::chrono::steady_clock::time_point releaseAt; // earliest a tick may fire it
+        std::chrono::steady_clock::time_point scheduleAnchor; // chunk k is due at anchor + (k+1) T/N
+        std::optional<std::chrono::steady_clock::time_point> startedAt;  // scheduler clock
+        std::optional<std::chrono::steady_clock::time_point> finishedAt;
+
+        // Market conditions the current schedule was planned for
+        double scheduleSigma{0.0};
+        double scheduleSpread{0.0};
+        double referenceSpread{0.0}; // spread the model's eta is taken to hold at
+
+        // Executed shares, running VWAP and history
+        void applyFill(const FillRecord& fill) {
+            executedShares += fill.shares;
+            double totalValue = averageExecutionPrice * (executedShares - fill.shares) + fill.shares * fill.price;
+            averageExecutionPrice = totalValue / executedShares;
+            executionHistory.push_back(fill);
+        }
 
         double remainingTime() const{
             return order.timeHorizon - executedShares;
@@ -83,41 +258,146 @@ private:
     ExecutionCallback executionCallback_;
     StatusCallback statusCallback_;
     ProgressCallback progressCallback_;
+    CallbackScope callbackScope_;
+
+    // Per-symbol re-optimization state. The atomics and order list are shared
+    // with the feed and submit paths; the estimator fields are only touched by
+    // the symbol's recompute task, which runs with symbol affinity and so never
+    // overlaps itself.
+    struct alignas(64) SymbolState {
+        std::atomic<bool> recomputePending{false};
+        std::atomic<bool> releasePending{false};
+        std::atomic<uint32_t> liveOrders{0};
+        std::mutex ordersMutex;
+        std::vector<OrderHandle> orders; // pruned lazily once terminal
+
+        double lastMid{0.0};
+        int64_t lastTimestampNs{0};
+        double variance{0.0}; // EWMA of squared log returns per second
+        uint32_t samples{0};
+        double spread{0.0};   // (ask - bid) / mid
+    };
+
+    std::optional<uint64_t> modelSeed_;
+    double reoptimizeThreshold_;
+    std::chrono::milliseconds marketDataCoalesce_;
+    ChunkTrigger chunkTrigger_;
+    double releaseWindow_;
+    symbol_table symbols_;
+    quote_board quotes_; // latest quote per SymbolId, seqlock per slot
+    simulated_book book_; // touched only by tasks with the symbol's affinity
+    std::unique_ptr<SymbolState[]> symbolStates_;
+    std::atomic<uint64_t> scheduleAdjustments_{0};
+    std::atomic<uint64_t> releasedChunks_{0};
+    schedule_cache scheduleCache_;
+    event_dispatcher dispatcher_; // outlives scheduler_, whose tasks publish to it
+    latency_histogram lockWait_;
+    latency_histogram callbackTime_;
+
+    // Last basket decomposition, reused while only the positions change. The
+    // model is immutable once cached; the mutex guards only the key and pointer
+    struct BasketModelCache {
+        std::mutex mutex;
+        std::vector<double> covariance;
+        std::vector<double> impact;
+        double riskAversion{0.0};
+        double timeHorizon{0.0};
+        std::shared_ptr<const PortfolioLiquidationModel> model;
+    };
+    BasketModelCache basketModel_;
 
     execution_scheduler scheduler_;
-    std::map<std::string, OrderExecutionContext> activeOrders_;
+    order_store<OrderExecutionContext> activeOrders_; // per-shard locks replace a global order mutex
+
+    // Declared last so the flusher, which may run checkpoint(), stops first.
+    // Submits hold submitGate_ shared from journaling to insertion; a
+    // checkpoint takes it exclusively to switch segments, so every submit in
+    // an older segment is already in the table when the snapshot is taken.
+    RecoveryStats recovery_;
+    std::shared_mutex submitGate_;
+    std::mutex checkpointMutex_;
+    std::unique_ptr<order_journal> journal_;
+
+    mutable std::mutex threadReportMutex_;
+    std::vector<ThreadReport> threadReports_;
 
-    std::map<std::string, MarketData> currentMarketData_;
+    static void validateOrder_(const Order& order);
+    // presetSchedules, when given, holds one ready schedule per order
+    std::vector<std::string> submitOrders_(const std::vector<Order>& orders,
+                                           const std::vector<std::vector<double>>* presetSchedules);
+    void buildOrderContext_(OrderExecutionContext& context, OrderHandle handle, SymbolId symbol,
+                            const Order& order, const std::vector<double>* presetSchedule = nullptr);
 
-    mutable std::mutex orderMutex_;
-    mutable std::mutex marketDataMutex_;
+    void registerWithSymbols_(std::vector<std::pair<SymbolId, OrderHandle>>& bySymbol);
+    void recover_(const JournalConfig& config);
+    static void journalSubmit_(order_journal::batch& records, OrderExecutionContext& context);
+    static void journalState_(order_journal::batch& records, const OrderExecutionContext& context);
 
+    // Helpers taking a context are called with its shard lock held
+    void journalStatus_(OrderExecutionContext& context);
+    void journalFill_(OrderExecutionContext& context, const FillRecord& fill);
+    void journalReschedule_(OrderExecutionContext& context, size_t from);
     void calculateOptimalSchedule_(OrderExecutionContext& context);
-    void scheduleNextChunk_(const std::string& orderId);
-    void executeTradeChunk_(const std::string& orderId, double shares);
-    void updateModelWithExecution_(const std::string& orderId, double executedShares, double price);
-    void handleCompletedOrder_(const std::string& orderId);
-    void adjustScheduleDynamically_(const std::string& orderId, const MarketData& newData);
+    void scheduleNextChunk_(OrderExecutionContext& context);
+    static std::chrono::steady_clock::duration chunkInterval_(const OrderExecutionContext& context);
+    // Makes the next chunk due one interval after `now`; on start, resume and recovery
+    static void anchorSchedule_(OrderExecutionContext& context, std::chrono::steady_clock::time_point now);
+    void executeTradeChunk_(OrderHandle handle, size_t chunkIndex);
+    // Every simulated fill steps the model once and counts in modelSteps, which
+    // recovery relies on to replay its price path; venue fills leave it alone
+    void applyExecution_(OrderExecutionContext& context, double shares, double price);
+    void updateModelWithExecution_(OrderHandle handle, double executedShares, double price);
+    void handleCompletedOrder_(OrderExecutionContext& context);
+    // A last chunk the book kept short well past the horizon: fails the order
+    void handleExpiredOrder_(OrderExecutionContext& context);
+    void recomputeSymbol_(SymbolId symbol);
+    void releaseChunks_(SymbolId symbol);
+    bool updateEstimates_(SymbolState& state, const MarketQuote& quote);
+    bool adjustScheduleDynamically_(OrderHandle handle, const SymbolState& state); // false once the order is done
+    void retireOrder_(OrderExecutionContext& context);
+    static bool isTerminal_(OrderStatus status) {
+        return status == OrderStatus::COMPLETED || status == OrderStatus::CANCELLED || status == OrderStatus::FAILED;
+    }
     
-    void createExecutionTask_(const std::string& orderId, double sharesToExecute);
+    void createExecutionTask_(OrderHandle handle, double sharesToExecute);
+    static uint64_t symbolAffinity_(SymbolId symbol) { return uint64_t{symbol} + 1; } // 0 = no affinity
+
+    void deliverEvents_(const EngineEvent* events, size_t count);
 
-    void emitExecution(const std::string& orderId, const std::string& symbol,
-                             double shares, double price,
-                             double totalExecuted, double totalShares)
-    {
+    // Called under the shard lock: only queues the event
+    void emitExecution(const OrderExecutionContext& context, double shares, double price) {
         if (executionCallback_) {
-            executionCallback_(orderId, symbol, shares, price, totalExecuted, totalShares);
+            EngineEvent event;
+            event.type = EngineEventType::Execution;
+            event.order = context.handle;
+            event.symbol = context.symbolId;
+            event.shares = shares;
+            event.price = price;
+            event.totalExecuted = context.executedShares;
+            event.totalShares = context.order.totalShares;
+            dispatcher_.publish(event);
         }
     }
-        void emitStatus(const std::string& orderId, OrderStatus status) {
+
+    void emitStatus(const OrderExecutionContext& context, OrderStatus status) {
         if (statusCallback_) {
-            statusCallback_(orderId, status);
+            EngineEvent event;
+            event.type = EngineEventType::Status;
+            event.order = context.handle;
+            event.symbol = context.symbolId;
+            event.status = status;
+            dispatcher_.publish(event);
         }
     }
     
-    void emitProgress(const std::string& orderId, double progressPercent) {
+    void emitProgress(const OrderExecutionContext& context, double progressPercent) {
         if (progressCallback_) {
-            progressCallback_(orderId, progressPercent);
+            EngineEvent event;
+            event.type = EngineEventType::Progress;
+            event.order = context.handle;
+            event.symbol = context.symbolId;
+            event.progressPercent = progressPercent;
+            dispatcher_.publish(event);
         }
     }
 };
\ No newline at end of file
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Almgren-Chriss trajectories,
+//   x(t) = X sinh(κ(T-t)) / sinh(κT),   v(t) = X κ cosh(κ(T-t)) / sinh(κT),
+// rewritten in terms of e^{-κt} and expm1(-2κ(T-t)) so nothing overflows for
+// large κT. Each order is classified once (Params::make) as Linear (κT below
+// 1e-10, including risk-neutral λ = 0: TWAP) or Hyperbolic, and the per-point
+// code is instantiated per shape, so evaluating a point has no branches. The
+// array loops have no exceptions or per-point checks and vectorize. Times
+// outside [0, T] are clamped rather than rejected.
+//
+// Against the former sinh-based scalar path (κT up to ~700, where sinh still
+// fits a double), shares and chunk sizes agree to within
+// kTrajectoryTolerance * X and rates to within kTrajectoryTolerance relative.
+namespace trajectory {
+
+constexpr double kTrajectoryTolerance = 1e-12;
+constexpr double kLinearKappaT = 1e-10;
+
+enum class Shape : uint8_t {
+    Linear,     // x(t) = X (1 - t/T)
+    Hyperbolic
+};
+
+namespace detail {
+
+template <size_t N>
+constexpr std::array<double, N> inverseFactorials() {
+    std::array<double, N> result{};
+    double factorial = 1.0;
+    for (size_t i = 0; i < N; ++i) {
+        factorial *= (i == 0 ? 1.0 : static_cast<double>(i));
+        result[i] = 1.0 / factorial;
+    }
+    return result;
+}
+
+inline constexpr auto kInverseFactorial = inverseFactorials<14>();
+
+// Selects rather than std::clamp/std::max (which take references and branch)
+// so they if-convert into min/max instructions
+constexpr double clampTo(double x, double lo, double hi) {
+    x = x < lo ? lo : x;
+    return x > hi ? hi : x;
+}
+
+constexpr double atLeastZero(double x) {
+    return x > 0.0 ? x : 0.0;
+}
+
+// sum_{i=First..Last} x^(i-First) / i!, expanded at compile time (Horner)
+template <size_t First, size_t Last>
+constexpr double taylor(double x) {
+    if constexpr (First == Last) {
+        return kInverseFactorial[First];
+    } else {
+        return kInverseFactorial[First] + x * taylor<First + 1, Last>(x);
+    }
+}
+
+// e^x = 2^k (1 + q) for x <= 0: range reduction x = k ln2 + r, |r| <= ln2/2,
+// and q = e^r - 1 from a degree 13 Taylor polynomial (error < 1e-17), with
+// 2^k built from the exponent bits. Inputs below -708 are clamped, which only
+// matters below ~1e-307. constexpr, so fixed schedules can fold at compile time.
+constexpr void expParts(double x, double& scale, double& q) {
+    constexpr double kLog2e = 1.4426950408889634;
+    constexpr double kLn2Hi = 6.93147180369123816490e-01; // low bits zero, so k * kLn2Hi is exact
+    constexpr double kLn2Lo = 1.90821492927058770002e-10;
+    constexpr double kRoundShift = 0x1.8p52;             // adding it rounds to an integer
+
+    x = clampTo(x, -708.0, 0.0);
+    double shifted = x * kLog2e + kRoundShift;
+    double k = shifted - kRoundShift;
+    double r = (x - k * kLn2Hi) - k * kLn2Lo;
+
+    q = r * taylor<1, 13>(r);
+    // The low mantissa bits of `shifted` hold k in two's complement
+    scale = std::bit_cast<double>((std::bit_cast<uint64_t>(shifted) + 1023) << 52);
+}
+
+constexpr double expNonPositive(double x) {
+    double scale = 0.0;
+    double q = 0.0;
+    expParts(x, scale, q);
+    return scale + scale * q;
+}
+
+// e^x - 1 = 2^k q + (2^k - 1): exact near zero (k = 0) and free of
+// cancellation elsewhere
+constexpr double expm1NonPositive(double x) {
+    double scale = 0.0;
+    double q = 0.0;
+    expParts(x, scale, q);
+    return scale * q + (scale - 1.0);
+}
+
+} // namespace detail
+
+// Per-trajectory constants, computed once when an order's parameters are set
+struct Params {
+    Shape shape{Shape::Linear};
+    double kappa{0.0};
+    double timeHorizon{1.0};
+    double totalShares{0.0};
+    double scale{0.0}; // Hyperbolic: X / expm1(-2κT)
+
+    static constexpr Params make(double kappa, double timeHorizon, double totalShares) {
+        Params p;
+        p.kappa = kappa;
+        p.timeHorizon = timeHorizon;
+        p.totalShares = totalShares;
+        if (kappa * timeHorizon >= kLinearKappaT) {
+            p.shape = Shape::Hyperbolic;
+            p.scale = totalShares / detail::expm1NonPositive(-2.0 * kappa * timeHorizon);
+        }
+        return p;
+    }
+};
+
+template <Shape S>
+constexpr double remainingAt(const Params& p, double t) {
+    t = detail::clampTo(t, 0.0, p.timeHorizon);
+    if constexpr (S == Shape::Linear) {
+        return p.totalShares * (1.0 - t / p.timeHorizon);
+    } else {
+        double x = p.scale * detail::expNonPositive(-p.kappa * t) *
+                   detail::expm1NonPositive(-2.0 * p.kappa * (p.timeHorizon - t));
+        return detail::clampTo(x, 0.0, p.totalShares);
+    }
+}
+
+template <Shape S>
+constexpr double rateAt(const Params& p, double t) {
+    if constexpr (S == Shape::Linear) {
+        return p.totalShares / p.timeHorizon;
+    } else {
+        t = detail::clampTo(t, 0.0, p.timeHorizon);
+        double v = -p.kappa * p.scale * detail::expNonPositive(-p.kappa * t) *
+                   (2.0 + detail::expm1NonPositive(-2.0 * p.kappa * (p.timeHorizon - t)));
+        return detail::atLeastZero(v);
+    }
+}
+
+namespace detail {
+template <Shape S, int Intervals, int... I>
+constexpr std::array<double, Intervals> fixedSchedule(const Params& p, std::integer_sequence<int, I...>) {
+    // Shares left at each interior boundary, then neighbour differences
+    constexpr double kIntervals = Intervals;
+    const std::array<double, Intervals + 1> left{
+        p.totalShares, remainingAt<S>(p, p.timeHorizon * ((I + 1) / kIntervals))..., 0.0};
+    return {atLeastZero(left[I] - left[I + 1])..., atLeastZero(left[Intervals - 1])};
+}
+} // namespace detail
+
+// Schedule with the interval count fixed at compile time: the boundary
+// evaluations are unrolled, and with constant Params the whole schedule
+// folds to constants
+template <Shape S, int Intervals>
+constexpr std::array<double, Intervals> fixedSchedule(const Params& p) {
+    static_assert(Intervals > 0, "a schedule needs at least one interval");
+    return detail::fixedSchedule<S, Intervals>(p, std::make_integer_sequence<int, Intervals - 1>{});
+}
+
+// Many trajectories as parallel arrays, one entry per order
+struct TrajectoryBatch {
+    std::vector<double> kappa;
+    std::vector<double> timeHorizon;
+    std::vector<double> totalShares;
+
+    size_t size() const { return kappa.size(); }
+    void add(double orderKappa, double orderTimeHorizon, double orderTotalShares) {
+        kappa.push_back(orderKappa);
+        timeHorizon.push_back(orderTimeHorizon);
+        totalShares.push_back(orderTotalShares);
+    }
+};
+
+// out[i] = x(times[i]) / v(times[i]) for one trajectory
+void remainingShares(const Params& params, const double* times, double* out, size_t count);
+void tradingRate(const Params& params, const double* times, double* out, size_t count);
+
+// Shares per interval for equal intervals over [0, T]. Every boundary is
+// evaluated once and the chunks are differences of neighbours, so they sum
+// to totalShares up to rounding. out has room for `intervals` values.
+void schedule(const Params& params, int intervals, double* out);
+
+// schedule() for every order in the batch; out is row-major, size() x intervals
+void scheduleBatch(const TrajectoryBatch& batch, int intervals, double* out);
+
+} // namespace trajectory
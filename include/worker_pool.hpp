@@ -0,0 +1,78 @@
+#pragma once
+
+#include "task_queue.hpp"
+#include "thread_tuning.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Fixed pool of workers. Each worker owns:
+//  - key queues: one FIFO per affinity key (symbol/order) homed on it. A key
+//    is claimed by one worker at a time, which runs its tasks in order, so
+//    tasks sharing a key never reorder or overlap. Unclaimed keys with work
+//    wait in the worker's ready list, and an idle worker may steal a whole key
+//    from another worker's ready list and drain it.
+//  - shared: tasks without affinity, which idle workers may steal from the back
+class worker_pool {
+public:
+    using Runner = std::function<void(ScheduledTask&)>;
+
+    worker_pool(size_t workers, Runner runner);
+    ~worker_pool();
+
+    worker_pool(const worker_pool&) = delete;
+    worker_pool& operator=(const worker_pool&) = delete;
+
+    void start();
+    void stop(); // drains nothing; queued tasks are dropped
+
+    void submit(ScheduledTask task);
+
+    size_t size() const { return workers_.size(); }
+    size_t queued() const;
+    std::vector<NamedThread> threads() const; // "ac-worker-<i>", while started
+    // Unpinned tasks plus whole keys taken from another worker
+    uint64_t steals() const { return steals_.load(std::memory_order_relaxed); }
+
+private:
+    // Tasks a claimer runs from a key before handing it back to the ready
+    // list, so one busy key cannot starve the others homed on its worker
+    static constexpr size_t kKeyBatch = 32;
+
+    struct KeyQueue {
+        std::deque<ScheduledTask> tasks;
+        bool claimed{false};
+    };
+
+    struct Worker {
+        mutable std::mutex mutex;
+        std::condition_variable condition;
+        std::unordered_map<uint64_t, KeyQueue> keys;
+        std::deque<uint64_t> ready;  // keys with tasks and no claimer
+        std::deque<ScheduledTask> shared;
+        size_t keyTasks{0};
+        bool sleeping{false};
+        bool woken{false};           // asked to look for work to steal
+        std::thread thread;
+    };
+
+    void workerLoop_(size_t index);
+    bool popShared_(Worker& worker, ScheduledTask& out, bool back);
+    bool claimKey_(Worker& home, uint64_t& key, bool back);
+    void drainKey_(Worker& home, uint64_t key);
+    bool steal_(size_t thief);
+    void wakeIdle_(size_t except);
+
+    Runner runner_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<bool> running_{false};
+    std::atomic<size_t> nextShared_{0};
+    std::atomic<uint64_t> steals_{0};
+};
@@ -11,7 +11,7 @@ Usage:
 
 from .almgren_chriss import (
     TradingEngine, Order, OrderStatus, ExecutionMetrics,
-    PENDING, ACTIVE, COMPLETED, CANCELLED
+    PENDING, ACTIVE, COMPLETED, CANCELLED, FAILED
 )
 
 __version__ = "1.0.0"
@@ -20,5 +20,5 @@ __all__ = [
     'Order', 
     'OrderStatus', 
     'ExecutionMetrics',
-    'PENDING', 'ACTIVE', 'COMPLETED', 'CANCELLED'
+    'PENDING', 'ACTIVE', 'COMPLETED', 'CANCELLED', 'FAILED'
 ]
\ No newline at end of file
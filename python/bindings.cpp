@@ -1,12 +1,128 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/chrono.h>
+#include <pybind11/numpy.h>
 #include <iostream>
+#include <memory>
 #include "../include/trading_engine.hpp"
 #include "../include/execution_metrics.hpp"
 
 namespace py = pybind11;
 
+PYBIND11_NUMPY_DTYPE(FillRecord, time, price, shares);
+PYBIND11_NUMPY_DTYPE(OrderMetricsRow, handle, status, totalShares, executedShares,
+                     averageExecutionPrice, implementationShortfall, progressPercent);
+
+namespace {
+// Hands a vector's buffer to NumPy without copying: the array owns the vector
+// through a capsule. Engine getters already copy once out of the order lock.
+template <typename T>
+py::array_t<T> toArray(std::vector<T>&& values) {
+    auto* owner = new std::vector<T>(std::move(values));
+    py::capsule release(owner, [](void* p) { delete static_cast<std::vector<T>*>(p); });
+    return py::array_t<T>(static_cast<py::ssize_t>(owner->size()), owner->data(), release);
+}
+
+// Runs fn without the GIL, then wraps its result
+template <typename Fn>
+auto arrayWithoutGil(Fn&& fn) {
+    decltype(fn()) values;
+    {
+        py::gil_scoped_release release;
+        values = fn();
+    }
+    return toArray(std::move(values));
+}
+
+py::dict toDict(const LatencySummary& summary) {
+    py::dict result;
+    result["count"] = summary.count;
+    result["mean_ns"] = summary.mean;
+    result["p50_ns"] = summary.p50;
+    result["p90_ns"] = summary.p90;
+    result["p99_ns"] = summary.p99;
+    result["p999_ns"] = summary.p999;
+    result["max_ns"] = summary.max;
+    return result;
+}
+
+py::dict toDict(const DispatchStats& stats) {
+    py::dict result;
+    result["queue_depth"] = stats.queueDepth;
+    result["published"] = stats.published;
+    result["delivered"] = stats.delivered;
+    result["dropped"] = stats.dropped;
+    result["backpressure_waits"] = stats.backpressureWaits;
+    result["batches"] = stats.batches;
+    return result;
+}
+
+py::dict toDict(const ScheduleCacheStats& stats) {
+    py::dict result;
+    result["hits"] = stats.hits;
+    result["misses"] = stats.misses;
+    result["evictions"] = stats.evictions;
+    result["size"] = stats.size;
+    result["capacity"] = stats.capacity;
+    result["hit_rate"] = stats.hitRate();
+    return result;
+}
+
+py::dict toDict(const JournalStats& stats) {
+    py::dict result;
+    result["records"] = stats.records;
+    result["bytes"] = stats.bytes;
+    result["commits"] = stats.commits;
+    result["segments"] = stats.segments;
+    result["snapshots"] = stats.snapshots;
+    return result;
+}
+
+py::dict toDict(const BookStats& stats) {
+    py::dict result;
+    result["rebuilds"] = stats.rebuilds;
+    result["takes"] = stats.takes;
+    result["partial_takes"] = stats.partialTakes;
+    result["levels"] = stats.levels;
+    return result;
+}
+
+py::dict toDict(const RecoveryStats& stats) {
+    py::dict result;
+    result["orders"] = stats.orders;
+    result["rescheduled"] = stats.rescheduled;
+    result["snapshot_records"] = stats.replay.snapshotRecords;
+    result["journal_records"] = stats.replay.segmentRecords;
+    result["torn_segments"] = stats.replay.tornSegments;
+    result["skipped_records"] = stats.skippedRecords;
+    result["elapsed_us"] = stats.elapsed.count(); // a number, so the dict stays JSON-serializable
+    return result;
+}
+
+// Holder deleter: shutdown() joins the scheduler and dispatcher threads, which
+// take the GIL to deliver their last callbacks, so it runs with the GIL
+// released; the engine is then freed with the GIL held, since it owns the
+// Python callables
+struct EngineDeleter {
+    void operator()(TradingEngine* engine) const {
+        {
+            py::gil_scoped_release release;
+            engine->shutdown();
+        }
+        delete engine;
+    }
+};
+
+// Callbacks arrive from the dispatcher thread in batches: take the GIL once per
+// batch instead of once per event
+void installGilScope(TradingEngine& engine) {
+    engine.setCallbackScope([](const std::function<void()>& deliver) {
+        py::gil_scoped_acquire acquire;
+        deliver();
+    });
+}
+}
+
 PYBIND11_MODULE(almgren_chriss, m) {
     m.doc() = "Almgren-Chriss Optimal Execution Engine";
     
@@ -20,6 +136,15 @@ PYBIND11_MODULE(almgren_chriss, m) {
         .def_readwrite("time_horizon", &TradingEngine::Order::timeHorizon)
         .def_readwrite("risk_aversion", &TradingEngine::Order::riskAversion)
         .def_readwrite("order_id", &TradingEngine::Order::orderId);
+
+    py::class_<TradingEngine::BasketOrder>(m, "BasketOrder")
+        .def(py::init<>())
+        .def_readwrite("legs", &TradingEngine::BasketOrder::legs)
+        .def_readwrite("covariance", &TradingEngine::BasketOrder::covariance)
+        .def_readwrite("impact", &TradingEngine::BasketOrder::impact)
+        .def_readwrite("risk_aversion", &TradingEngine::BasketOrder::riskAversion)
+        .def_readwrite("time_horizon", &TradingEngine::BasketOrder::timeHorizon)
+        .def_readwrite("num_intervals", &TradingEngine::BasketOrder::numIntervals);
     
     // ExecutionMetrics
     py::class_<ExecutionMetrics>(m, "ExecutionMetrics")
@@ -27,7 +152,17 @@ PYBIND11_MODULE(almgren_chriss, m) {
         .def_readwrite("total_shares", &ExecutionMetrics::totalShares)
         .def_readwrite("executed_shares", &ExecutionMetrics::executedShares)
         .def_readwrite("average_execution_price", &ExecutionMetrics::averageExecutionPrice)
-        .def_readwrite("implementation_shortfall", &ExecutionMetrics::implementationShortfall);
+        .def_readwrite("implementation_shortfall", &ExecutionMetrics::implementationShortfall)
+        .def_readwrite("execution_time", &ExecutionMetrics::executionTime);
+    
+    // MonteCarloResult
+    py::class_<MonteCarloResult>(m, "MonteCarloResult")
+        .def_readonly("paths", &MonteCarloResult::paths)
+        .def_readonly("mean", &MonteCarloResult::mean)
+        .def_readonly("variance", &MonteCarloResult::variance)
+        .def_readonly("std_dev", &MonteCarloResult::stdDev)
+        .def_readonly("quantiles", &MonteCarloResult::quantiles)
+        .def("quantile", &MonteCarloResult::quantile, py::arg("level"));
     
     // OrderStatus enum
     py::enum_<OrderStatus>(m, "OrderStatus")
@@ -35,27 +170,87 @@ PYBIND11_MODULE(almgren_chriss, m) {
         .value("ACTIVE", OrderStatus::ACTIVE)
         .value("COMPLETED", OrderStatus::COMPLETED)
         .value("CANCELLED", OrderStatus::CANCELLED)
+        .value("FAILED", OrderStatus::FAILED)
         .export_values();
     
     // TradingEngine 
-    py::class_<TradingEngine>(m, "TradingEngine")
+    py::class_<TradingEngine, std::unique_ptr<TradingEngine, EngineDeleter>>(m, "TradingEngine")
         .def(py::init<>())
         .def("initialize", &TradingEngine::initialize, py::arg("config_path") = "")
-        .def("shutdown", &TradingEngine::shutdown)
+        .def("thread_report", [](const TradingEngine& engine) {
+            py::list reports;
+            for (const ThreadReport& report : engine.threadReport()) {
+                reports.append(report.describe());
+            }
+            return reports;
+        })
+        .def("shutdown", &TradingEngine::shutdown, py::call_guard<py::gil_scoped_release>())
         .def("submit_order", &TradingEngine::submitOrder)
-        .def("start_execution", &TradingEngine::startExecution)
-        .def("get_order_status", &TradingEngine::getOrderStatus)
-        .def("get_order_metrics", &TradingEngine::getOrderMetrics)
-        .def("get_remaining_schedule", &TradingEngine::getRemainingSchedule)
+        .def("submit_orders", &TradingEngine::submitOrders, py::arg("orders"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("submit_basket", &TradingEngine::submitBasket, py::arg("basket"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("start_executions", py::overload_cast<const std::vector<std::string>&>(&TradingEngine::startExecutions),
+             py::arg("order_ids"), py::call_guard<py::gil_scoped_release>())
+        .def("start_execution", py::overload_cast<const std::string&>(&TradingEngine::startExecution),
+             py::call_guard<py::gil_scoped_release>())
+        .def("cancel_order", py::overload_cast<const std::string&>(&TradingEngine::cancelOrder),
+             py::call_guard<py::gil_scoped_release>())
+        .def("pause_execution", py::overload_cast<const std::string&>(&TradingEngine::pauseExecution),
+             py::call_guard<py::gil_scoped_release>())
+        .def("resume_execution", py::overload_cast<const std::string&>(&TradingEngine::resumeExecution),
+             py::call_guard<py::gil_scoped_release>())
+        .def("get_order_status", py::overload_cast<const std::string&>(&TradingEngine::getOrderStatus, py::const_))
+        .def("get_order_metrics", py::overload_cast<const std::string&>(&TradingEngine::getOrderMetrics, py::const_))
+        .def("get_remaining_schedule", py::overload_cast<const std::string&>(&TradingEngine::getRemainingSchedule, py::const_))
+        .def("remaining_schedule_array", [](const TradingEngine& engine, const std::string& orderId) {
+            return arrayWithoutGil([&] { return engine.getRemainingSchedule(orderId); });
+        }, py::arg("order_id"))
+        .def("execution_history", [](const TradingEngine& engine, const std::string& orderId) {
+            return arrayWithoutGil([&] { return engine.getExecutionHistory(orderId); });
+        }, py::arg("order_id"), "Structured array with fields time, price, shares")
+        .def("all_order_metrics", [](const TradingEngine& engine) {
+            return arrayWithoutGil([&] { return engine.getAllOrderMetrics(); });
+        }, "Structured array, one row per order, sorted by handle")
+        .def_static("order_handle", &TradingEngine::handleOf, py::arg("order_id"))
+        .def("simulate_execution_cost", &TradingEngine::simulateExecutionCost,
+             py::arg("order_id"), py::arg("paths") = 10000, py::arg("seed") = 0,
+             py::call_guard<py::gil_scoped_release>())
+        .def("get_dispatch_stats", [](const TradingEngine& engine) {
+            return toDict(engine.dispatchStats());
+        })
+        .def("get_stats", [](const TradingEngine& engine) {
+            EngineStats stats = engine.stats();
+            py::dict result;
+            result["dispatch_lag"] = toDict(stats.dispatchLag);
+            result["task_run_time"] = toDict(stats.taskRunTime);
+            result["lock_wait"] = toDict(stats.lockWait);
+            result["lock_acquisitions"] = stats.lockAcquisitions;
+            result["callback_time"] = toDict(stats.callbackTime);
+            result["dispatch"] = toDict(stats.dispatch);
+            result["schedule_cache"] = toDict(stats.scheduleCache);
+            result["journal"] = toDict(stats.journal);
+            result["recovery"] = toDict(stats.recovery);
+            result["book"] = toDict(stats.book);
+            result["pending_tasks"] = stats.pendingTasks;
+            result["schedule_adjustments"] = stats.scheduleAdjustments;
+            result["released_chunks"] = stats.releasedChunks;
+            return result;
+        })
+        .def("flush_events", &TradingEngine::flushEvents, py::call_guard<py::gil_scoped_release>())
+        .def("on_execution_report", [](TradingEngine& engine, const std::string& orderId, double shares, double price) {
+            engine.onExecutionReport(TradingEngine::handleOf(orderId), shares, price);
+        }, py::arg("order_id"), py::arg("shares"), py::arg("price"))
+        .def("checkpoint", &TradingEngine::checkpoint, py::call_guard<py::gil_scoped_release>())
         .def("set_execution_callback", [](TradingEngine& engine, py::function callback) {
+            installGilScope(engine);
             engine.setExecutionCallback([callback](const std::string& orderId,
                                                    const std::string& symbol,
                                                    double shares,
                                                    double price,
                                                    double totalExecuted,
                                                    double totalShares) {
-                // Acquire GIL for Python thread safety
-                py::gil_scoped_acquire acquire;
+                // GIL is already held for the whole batch
                 try {
                     callback(orderId, symbol, shares, price, totalExecuted, totalShares);
                 } catch (const py::error_already_set& e) {
@@ -67,8 +262,8 @@ PYBIND11_MODULE(almgren_chriss, m) {
             });
         }, py::arg("callback"))
         .def("set_status_callback", [](TradingEngine& engine, py::function callback) {
+            installGilScope(engine);
             engine.setStatusCallback([callback](const std::string& orderId, OrderStatus status) {
-                py::gil_scoped_acquire acquire;
                 try {
                     callback(orderId, static_cast<int>(status));
                 } catch (const py::error_already_set& e) {
@@ -77,8 +272,8 @@ PYBIND11_MODULE(almgren_chriss, m) {
             });
         }, py::arg("callback"))
         .def("set_progress_callback", [](TradingEngine& engine, py::function callback) {
+            installGilScope(engine);
             engine.setProgressCallback([callback](const std::string& orderId, double progress) {
-                py::gil_scoped_acquire acquire;
                 try {
                     callback(orderId, progress);
                 } catch (const py::error_already_set& e) {
@@ -86,4 +281,4 @@ PYBIND11_MODULE(almgren_chriss, m) {
                 }
             });
         }, py::arg("callback"));
-}
\ No newline at end of file
+}
@@ -131,6 +131,20 @@ def cancel_order(order_id):
     except Exception as e:
         return jsonify({'error': str(e)}), 500
 
+@app.route('/api/orders/<order_id>/history', methods=['GET'])
+def get_order_history(order_id):
+    """Fill history and remaining schedule for charts"""
+    if order_id not in orders:
+        return jsonify({'error': 'Order not found'}), 404
+
+    fills = engine.execution_history(order_id)
+    return jsonify({
+        'time': fills['time'].tolist(),
+        'price': fills['price'].tolist(),
+        'shares': fills['shares'].tolist(),
+        'remaining_schedule': engine.remaining_schedule_array(order_id).tolist()
+    })
+
 @app.route('/api/stats', methods=['GET'])
 def get_stats():
     """Get engine statistics"""
@@ -142,7 +156,8 @@ def get_stats():
         'active_orders': active_orders,
         'completed_orders': completed_orders,
         'total_orders': len(orders),
-        'total_shares': total_shares
+        'total_shares': total_shares,
+        'engine': engine.get_stats()
     })
 
 def execute_order(order_id):
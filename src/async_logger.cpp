@@ -0,0 +1,268 @@
+#include "async_logger.hpp"
+#include <charconv>
+#include <ctime>
+#include <stdexcept>
+
+namespace {
+
+const char* levelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Info: return "INFO";
+        case LogLevel::Warn: return "WARN";
+        case LogLevel::Error: return "ERROR";
+        default: return "OFF";
+    }
+}
+
+void appendTimestamp(std::string& out, int64_t timestampNs) {
+    std::time_t seconds = static_cast<std::time_t>(timestampNs / 1'000'000'000);
+    std::tm utc{};
+    gmtime_r(&seconds, &utc);
+    char buffer[40];
+    size_t length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", &utc);
+    int micros = static_cast<int>((timestampNs % 1'000'000'000) / 1000);
+    length += static_cast<size_t>(std::snprintf(buffer + length, sizeof(buffer) - length, ".%06dZ", micros));
+    out.append(buffer, length);
+}
+
+template <typename T>
+void appendNumber(std::string& out, T value) {
+    char buffer[32];
+    auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, ec == std::errc{} ? end : buffer);
+}
+
+void appendEscaped(std::string& out, std::string_view text) {
+    for (char c : text) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    out += buffer;
+                } else {
+                    out += c;
+                }
+        }
+    }
+}
+
+void appendArg(std::string& out, const LogRecord& record, size_t index, bool quoteText) {
+    const auto& value = record.values[index];
+    switch (record.types[index]) {
+        case LogRecord::Int: appendNumber(out, value.i); break;
+        case LogRecord::UInt: appendNumber(out, value.u); break;
+        case LogRecord::Double: appendNumber(out, value.d); break;
+        case LogRecord::Bool: out += value.u ? "true" : "false"; break;
+        case LogRecord::Text: {
+            std::string_view text(record.text + value.text.offset, value.text.length);
+            if (quoteText) {
+                out += '"';
+                appendEscaped(out, text);
+                out += '"';
+            } else {
+                out += text;
+            }
+            break;
+        }
+    }
+}
+
+} // namespace
+
+async_logger& async_logger::instance() {
+    static async_logger logger;
+    return logger;
+}
+
+async_logger::async_logger() {
+    writer_ = std::thread(&async_logger::run_, this);
+    thread_tuning::setName(writer_.native_handle(), "ac-logger");
+}
+
+std::vector<NamedThread> async_logger::threads() {
+    return {{"ac-logger", writer_.native_handle()}};
+}
+
+async_logger::~async_logger() {
+    {
+        std::lock_guard lock(wakeMutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+    std::lock_guard lock(writeMutex_);
+    drainAll_();
+    if (ownsOut_) {
+        std::fclose(out_);
+    }
+}
+
+void async_logger::configure(const LoggerConfig& config) {
+    std::lock_guard lock(writeMutex_);
+    drainAll_(); // pending records go to the old destination
+
+    FILE* out = stdout;
+    if (!config.path.empty()) {
+        out = std::fopen(config.path.c_str(), "a");
+        if (out == nullptr) {
+            throw std::runtime_error("Cannot open log file: " + config.path);
+        }
+    }
+    if (ownsOut_) {
+        std::fclose(out_);
+    }
+    out_ = out;
+    ownsOut_ = out != stdout;
+    outputFormat_ = config.format;
+    level_.store(config.level, std::memory_order_relaxed);
+    recordsPerThread_.store(std::max<size_t>(config.recordsPerThread, 2), std::memory_order_relaxed);
+    {
+        std::lock_guard wakeLock(wakeMutex_);
+        flushInterval_ = config.flushInterval;
+    }
+}
+
+async_logger::ThreadBuffer& async_logger::localBuffer_() {
+    // The registry keeps the buffer alive after its thread exits until the
+    // writer has drained it
+    struct Holder {
+        std::shared_ptr<ThreadBuffer> buffer;
+        ~Holder() {
+            if (buffer) {
+                buffer->retired.store(true, std::memory_order_release);
+            }
+        }
+    };
+    thread_local Holder holder;
+
+    if (!holder.buffer) {
+        holder.buffer = std::make_shared<ThreadBuffer>(recordsPerThread_.load(std::memory_order_relaxed),
+                                                       nextThreadId_.fetch_add(1, std::memory_order_relaxed));
+        std::lock_guard lock(registryMutex_);
+        buffers_.push_back(holder.buffer);
+    }
+    return *holder.buffer;
+}
+
+LogRecord* async_logger::claim_() {
+    ThreadBuffer& buffer = localBuffer_();
+    size_t tail = buffer.tail.load(std::memory_order_relaxed);
+    if (tail - buffer.head.load(std::memory_order_acquire) >= buffer.records.size()) {
+        return nullptr;
+    }
+    return &buffer.records[tail % buffer.records.size()];
+}
+
+void async_logger::commit_() {
+    ThreadBuffer& buffer = localBuffer_();
+    buffer.tail.store(buffer.tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void async_logger::flush() {
+    std::lock_guard lock(writeMutex_);
+    drainAll_();
+}
+
+void async_logger::run_() {
+    std::unique_lock lock(wakeMutex_);
+    while (!stopping_) {
+        wake_.wait_for(lock, flushInterval_, [this] { return stopping_; });
+        lock.unlock();
+        {
+            std::lock_guard writeLock(writeMutex_);
+            drainAll_();
+        }
+        lock.lock();
+    }
+}
+
+void async_logger::drainAll_() {
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard lock(registryMutex_);
+        buffers = buffers_;
+    }
+
+    bool finished = false;
+    for (const auto& buffer : buffers) {
+        // Read retired before tail: a retired buffer gets no further records
+        bool retired = buffer->retired.load(std::memory_order_acquire);
+        size_t head = buffer->head.load(std::memory_order_relaxed);
+        size_t tail = buffer->tail.load(std::memory_order_acquire);
+        for (; head != tail; ++head) {
+            format_(buffer->records[head % buffer->records.size()], buffer->threadId);
+        }
+        buffer->head.store(head, std::memory_order_release);
+        finished = finished || retired;
+    }
+
+    if (!line_.empty()) {
+        std::fwrite(line_.data(), 1, line_.size(), out_);
+        std::fflush(out_);
+        line_.clear();
+    }
+
+    if (finished) {
+        std::lock_guard lock(registryMutex_);
+        std::erase_if(buffers_, [](const std::shared_ptr<ThreadBuffer>& buffer) {
+            return buffer->retired.load(std::memory_order_acquire) &&
+                   buffer->head.load(std::memory_order_relaxed) == buffer->tail.load(std::memory_order_acquire);
+        });
+    }
+}
+
+void async_logger::format_(const LogRecord& record, uint32_t threadId) {
+    bool json = outputFormat_ == LogFormat::Json;
+    if (json) {
+        line_ += "{\"ts\":\"";
+        appendTimestamp(line_, record.timestampNs);
+        line_ += "\",\"level\":\"";
+        line_ += levelName(record.level);
+        line_ += "\",\"thread\":";
+        appendNumber(line_, threadId);
+        line_ += ",\"msg\":\"";
+    } else {
+        appendTimestamp(line_, record.timestampNs);
+        line_ += ' ';
+        line_ += levelName(record.level);
+        line_.append(6 - std::strlen(levelName(record.level)), ' ');
+        line_ += "[t";
+        appendNumber(line_, threadId);
+        line_ += "] ";
+    }
+
+    // Substitute {} placeholders in order; extra placeholders print as-is
+    std::string message;
+    size_t next = 0;
+    for (const char* p = record.format; *p != '\0'; ++p) {
+        if (p[0] == '{' && p[1] == '}' && next < record.argCount) {
+            appendArg(message, record, next++, false);
+            ++p;
+        } else {
+            message += *p;
+        }
+    }
+
+    if (json) {
+        appendEscaped(line_, message);
+        line_ += "\",\"args\":[";
+        for (size_t i = 0; i < record.argCount; ++i) {
+            if (i != 0) {
+                line_ += ',';
+            }
+            appendArg(line_, record, i, true);
+        }
+        line_ += "]}\n";
+    } else {
+        line_ += message;
+        line_ += '\n';
+    }
+}
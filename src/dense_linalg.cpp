@@ -0,0 +1,451 @@
+#include "dense_linalg.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace {
+constexpr size_t kPanel = 64;        // Cholesky panel width
+constexpr size_t kSlice = 64;        // columns per cache-resident slice
+constexpr size_t kRowChunk = 8;      // rows handed out together in triangular updates
+constexpr size_t kRowsPerWorker = 32;
+
+// Four independent accumulators: keeps the adds pipelined and the result
+// independent of how rows are split between threads
+double dot(const double* x, const double* y, size_t n) {
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += x[i] * y[i];
+        s1 += x[i + 1] * y[i + 1];
+        s2 += x[i + 2] * y[i + 2];
+        s3 += x[i + 3] * y[i + 3];
+    }
+    for (; i < n; ++i) {
+        s0 += x[i] * y[i];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+void requireSquare(const dense_matrix& a, const char* what) {
+    if (a.rows() != a.cols()) {
+        throw std::invalid_argument(std::string(what) + " needs a square matrix");
+    }
+}
+
+struct Rotation {
+    uint32_t index; // acts on rows index and index + 1
+    double c;
+    double s;
+};
+
+// Implicit QL with Wilkinson shifts on the tridiagonal (d, e), e[i] coupling
+// i and i + 1. Leaves eigenvalues in d; every rotation is recorded so the
+// eigenvectors can be formed afterwards, in parallel.
+void tridiagonalQl(std::vector<double>& d, std::vector<double>& e, std::vector<Rotation>& rotations) {
+    const size_t n = d.size();
+    for (size_t l = 0; l < n; ++l) {
+        int iterations = 0;
+        size_t m;
+        do {
+            for (m = l; m + 1 < n; ++m) {
+                double dd = std::abs(d[m]) + std::abs(d[m + 1]);
+                if (std::abs(e[m]) <= DBL_EPSILON * dd) {
+                    break;
+                }
+            }
+            if (m == l) {
+                break;
+            }
+            if (++iterations > 60) {
+                throw std::runtime_error("symmetricEigen: QL iteration did not converge");
+            }
+            double g = (d[l + 1] - d[l]) / (2.0 * e[l]);
+            double r = std::hypot(g, 1.0);
+            g = d[m] - d[l] + e[l] / (g + std::copysign(r, g));
+            double s = 1.0;
+            double c = 1.0;
+            double p = 0.0;
+            bool deflated = false;
+            for (size_t i = m; i-- > l;) {
+                double f = s * e[i];
+                double b = c * e[i];
+                r = std::hypot(f, g);
+                e[i + 1] = r;
+                if (r == 0.0) {
+                    d[i + 1] -= p;
+                    e[m] = 0.0;
+                    deflated = true;
+                    break;
+                }
+                s = f / r;
+                c = g / r;
+                g = d[i + 1] - p;
+                r = (d[i] - g) * s + 2.0 * c * b;
+                p = s * r;
+                d[i + 1] = g + p;
+                g = c * r - b;
+                rotations.push_back({static_cast<uint32_t>(i), c, s});
+            }
+            if (deflated) {
+                continue;
+            }
+            d[l] -= p;
+            e[l] = g;
+            e[m] = 0.0;
+        } while (m != l);
+    }
+}
+} // namespace
+
+dense_matrix dense_matrix::identity(size_t n) {
+    dense_matrix result(n, n);
+    for (size_t i = 0; i < n; ++i) {
+        result(i, i) = 1.0;
+    }
+    return result;
+}
+
+dense_matrix dense_matrix::fromRowMajor(size_t rows, size_t cols, const std::vector<double>& values) {
+    if (values.size() != rows * cols) {
+        throw std::invalid_argument("matrix needs " + std::to_string(rows * cols) + " values, got " +
+                                    std::to_string(values.size()));
+    }
+    dense_matrix result(rows, cols);
+    result.data_ = values;
+    return result;
+}
+
+dense_matrix dense_matrix::transposed() const {
+    constexpr size_t kTile = 32;
+    dense_matrix result(cols_, rows_);
+    for (size_t r0 = 0; r0 < rows_; r0 += kTile) {
+        for (size_t c0 = 0; c0 < cols_; c0 += kTile) {
+            for (size_t r = r0; r < std::min(rows_, r0 + kTile); ++r) {
+                for (size_t c = c0; c < std::min(cols_, c0 + kTile); ++c) {
+                    result(c, r) = (*this)(r, c);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+parallel_team::parallel_team(unsigned threads) {
+    unsigned total = threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads;
+    threads_.reserve(total - 1);
+    for (unsigned w = 1; w < total; ++w) {
+        threads_.emplace_back(&parallel_team::workerLoop_, this, w);
+    }
+}
+
+parallel_team::~parallel_team() {
+    stopping_.store(true, std::memory_order_relaxed);
+    generation_.fetch_add(1, std::memory_order_release);
+    generation_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void parallel_team::execute_(unsigned worker) {
+    try {
+        (*task_)(worker, size());
+    } catch (...) {
+        std::lock_guard lock(errorMutex_);
+        if (!error_) {
+            error_ = std::current_exception();
+        }
+    }
+}
+
+void parallel_team::workerLoop_(unsigned worker) {
+    uint32_t seen = 0;
+    while (true) {
+        generation_.wait(seen, std::memory_order_acquire);
+        uint32_t current = generation_.load(std::memory_order_acquire);
+        if (current == seen) {
+            continue;
+        }
+        seen = current;
+        if (stopping_.load(std::memory_order_relaxed)) {
+            return;
+        }
+        execute_(worker);
+        if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            remaining_.notify_one();
+        }
+    }
+}
+
+void parallel_team::run(const std::function<void(unsigned, unsigned)>& fn) {
+    if (threads_.empty()) {
+        fn(0, 1);
+        return;
+    }
+    task_ = &fn;
+    remaining_.store(static_cast<uint32_t>(threads_.size()), std::memory_order_relaxed);
+    generation_.fetch_add(1, std::memory_order_release);
+    generation_.notify_all();
+
+    execute_(0);
+    for (uint32_t left = remaining_.load(std::memory_order_acquire); left != 0;
+         left = remaining_.load(std::memory_order_acquire)) {
+        remaining_.wait(left, std::memory_order_acquire);
+    }
+    task_ = nullptr;
+
+    std::exception_ptr error;
+    {
+        std::lock_guard lock(errorMutex_);
+        std::swap(error, error_);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void parallel_team::parallelFor(size_t count, size_t minPerWorker,
+                                const std::function<void(size_t, size_t)>& fn) {
+    size_t workers = std::min<size_t>(size(), count / std::max<size_t>(minPerWorker, 1));
+    if (workers <= 1) {
+        if (count > 0) {
+            fn(0, count);
+        }
+        return;
+    }
+    run([&](unsigned worker, unsigned) {
+        if (worker < workers) {
+            fn(count * worker / workers, count * (worker + 1) / workers);
+        }
+    });
+}
+
+namespace linalg {
+
+void choleskyInPlace(dense_matrix& a, parallel_team& team) {
+    requireSquare(a, "choleskyInPlace");
+    const size_t n = a.rows();
+
+    for (size_t k0 = 0; k0 < n; k0 += kPanel) {
+        const size_t k1 = std::min(n, k0 + kPanel);
+        const size_t width = k1 - k0;
+
+        // Diagonal block; earlier panels were already subtracted from it
+        for (size_t j = k0; j < k1; ++j) {
+            double* rj = a.row(j);
+            double diagonal = rj[j] - dot(rj + k0, rj + k0, j - k0);
+            if (!(diagonal > 0.0)) {
+                throw std::invalid_argument("choleskyInPlace: matrix is not positive definite");
+            }
+            rj[j] = std::sqrt(diagonal);
+            for (size_t i = j + 1; i < k1; ++i) {
+                double* ri = a.row(i);
+                ri[j] = (ri[j] - dot(ri + k0, rj + k0, j - k0)) / rj[j];
+            }
+        }
+
+        // Panel below the diagonal block
+        team.parallelFor(n - k1, kRowsPerWorker, [&](size_t begin, size_t end) {
+            for (size_t i = k1 + begin; i < k1 + end; ++i) {
+                double* ri = a.row(i);
+                for (size_t j = k0; j < k1; ++j) {
+                    const double* rj = a.row(j);
+                    ri[j] = (ri[j] - dot(ri + k0, rj + k0, j - k0)) / rj[j];
+                }
+            }
+        });
+
+        // Trailing lower triangle: A22 -= P P^T, rows dealt out in chunks so
+        // the longer rows near the bottom spread over every worker
+        const size_t trailing = n - k1;
+        if (trailing == 0) {
+            continue;
+        }
+        auto update = [&](unsigned worker, unsigned workers) {
+            for (size_t chunk = worker; chunk * kRowChunk < trailing; chunk += workers) {
+                size_t end = std::min(trailing, (chunk + 1) * kRowChunk);
+                for (size_t i = k1 + chunk * kRowChunk; i < k1 + end; ++i) {
+                    double* ri = a.row(i);
+                    for (size_t j = k1; j <= i; ++j) {
+                        ri[j] -= dot(ri + k0, a.row(j) + k0, width);
+                    }
+                }
+            }
+        };
+        if (trailing < 2 * kRowsPerWorker) {
+            update(0, 1);
+        } else {
+            team.run(update);
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        std::fill(a.row(i) + i + 1, a.row(i) + n, 0.0);
+    }
+}
+
+void solveLowerInPlace(const dense_matrix& l, dense_matrix& b, parallel_team& team) {
+    requireSquare(l, "solveLowerInPlace");
+    if (b.rows() != l.rows()) {
+        throw std::invalid_argument("solveLowerInPlace: row count mismatch");
+    }
+    const size_t n = l.rows();
+    const size_t slices = (b.cols() + kSlice - 1) / kSlice;
+
+    team.parallelFor(slices, 1, [&](size_t begin, size_t end) {
+        for (size_t slice = begin; slice < end; ++slice) {
+            const size_t c0 = slice * kSlice;
+            const size_t width = std::min(b.cols(), c0 + kSlice) - c0;
+            for (size_t i = 0; i < n; ++i) {
+                const double* li = l.row(i);
+                double* bi = b.row(i) + c0;
+                for (size_t p = 0; p < i; ++p) {
+                    const double f = li[p];
+                    if (f == 0.0) {
+                        continue;
+                    }
+                    const double* bp = b.row(p) + c0;
+                    for (size_t c = 0; c < width; ++c) {
+                        bi[c] -= f * bp[c];
+                    }
+                }
+                const double inverse = 1.0 / li[i];
+                for (size_t c = 0; c < width; ++c) {
+                    bi[c] *= inverse;
+                }
+            }
+        }
+    });
+}
+
+void solveLowerTransposedInPlace(const dense_matrix& l, double* x) {
+    // L^T is upper triangular: back substitution, sweeping row i of L
+    // (column i of L^T) into the entries above once x[i] is known
+    for (size_t i = l.rows(); i-- > 0;) {
+        const double* li = l.row(i);
+        x[i] /= li[i];
+        const double xi = x[i];
+        for (size_t p = 0; p < i; ++p) {
+            x[p] -= li[p] * xi;
+        }
+    }
+}
+
+void symmetricEigen(dense_matrix& a, std::vector<double>& eigenvalues, dense_matrix& eigenvectorRows,
+                    parallel_team& team) {
+    requireSquare(a, "symmetricEigen");
+    const size_t n = a.rows();
+    eigenvalues.assign(n, 0.0);
+    eigenvectorRows = dense_matrix::identity(n);
+    if (n == 0) {
+        return;
+    }
+
+    // 1. Householder: A <- H_k A H_k zeroes column k below the subdiagonal.
+    //    Reflector k lives in row k of `reflectors`, entries k+1..n-1.
+    std::vector<double> d(n, 0.0);
+    std::vector<double> e(n, 0.0);
+    std::vector<double> beta(n, 0.0);
+    dense_matrix reflectors(n, n);
+    std::vector<double> p(n);
+    std::vector<double> w(n);
+
+    for (size_t k = 0; k + 2 < n; ++k) {
+        const size_t m = n - k - 1;
+        const double* x = a.row(k) + k + 1; // column k below the diagonal, by symmetry
+        d[k] = a(k, k);
+        double tail = dot(x + 1, x + 1, m - 1);
+        if (tail == 0.0) {
+            e[k] = x[0];
+            continue;
+        }
+        double alpha = -std::copysign(std::sqrt(x[0] * x[0] + tail), x[0]);
+        double* v = reflectors.row(k) + k + 1;
+        v[0] = x[0] - alpha;
+        std::copy(x + 1, x + m, v + 1);
+        const double b = 2.0 / (v[0] * v[0] + tail);
+        beta[k] = b;
+        e[k] = alpha;
+
+        // p = b A22 v; w = p - (b/2)(p.v) v; A22 -= v w^T + w v^T
+        team.parallelFor(m, kRowsPerWorker, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                p[i] = b * dot(a.row(k + 1 + i) + k + 1, v, m);
+            }
+        });
+        const double K = 0.5 * b * dot(p.data(), v, m);
+        for (size_t i = 0; i < m; ++i) {
+            w[i] = p[i] - K * v[i];
+        }
+        team.parallelFor(m, kRowsPerWorker, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                double* row = a.row(k + 1 + i) + k + 1;
+                const double vi = v[i];
+                const double wi = w[i];
+                for (size_t j = 0; j < m; ++j) {
+                    row[j] -= vi * w[j] + wi * v[j];
+                }
+            }
+        });
+    }
+    if (n >= 2) {
+        d[n - 2] = a(n - 2, n - 2);
+        e[n - 2] = a(n - 2, n - 1);
+    }
+    d[n - 1] = a(n - 1, n - 1);
+    e[n - 1] = 0.0;
+
+    // 2. Eigenvalues of the tridiagonal, recording the rotations
+    std::vector<Rotation> rotations;
+    rotations.reserve(3 * n * n / 2);
+    tridiagonalQl(d, e, rotations);
+    eigenvalues = d;
+
+    // 3. U^T = G_R^T ... G_1^T H_{n-3} ... H_0, built in column slices: each
+    //    worker applies every reflector and rotation to a slice that stays in cache
+    dense_matrix& z = eigenvectorRows;
+    const size_t slices = (n + kSlice - 1) / kSlice;
+    team.parallelFor(slices, 1, [&](size_t begin, size_t end) {
+        std::vector<double> acc(kSlice);
+        for (size_t slice = begin; slice < end; ++slice) {
+            const size_t c0 = slice * kSlice;
+            const size_t width = std::min(n, c0 + kSlice) - c0;
+
+            for (size_t k = 0; k + 2 < n; ++k) {
+                if (beta[k] == 0.0) {
+                    continue;
+                }
+                const double* v = reflectors.row(k);
+                std::fill(acc.begin(), acc.begin() + width, 0.0);
+                for (size_t r = k + 1; r < n; ++r) {
+                    const double f = v[r];
+                    const double* zr = z.row(r) + c0;
+                    for (size_t c = 0; c < width; ++c) {
+                        acc[c] += f * zr[c];
+                    }
+                }
+                for (size_t r = k + 1; r < n; ++r) {
+                    const double f = beta[k] * v[r];
+                    double* zr = z.row(r) + c0;
+                    for (size_t c = 0; c < width; ++c) {
+                        zr[c] -= f * acc[c];
+                    }
+                }
+            }
+
+            for (const Rotation& rotation : rotations) {
+                double* zi = z.row(rotation.index) + c0;
+                double* zj = z.row(rotation.index + 1) + c0;
+                for (size_t c = 0; c < width; ++c) {
+                    const double f = zj[c];
+                    zj[c] = rotation.s * zi[c] + rotation.c * f;
+                    zi[c] = rotation.c * zi[c] - rotation.s * f;
+                }
+            }
+        }
+    });
+}
+
+} // namespace linalg
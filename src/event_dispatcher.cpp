@@ -0,0 +1,136 @@
+#include "event_dispatcher.hpp"
+#include "async_logger.hpp"
+
+event_dispatcher::event_dispatcher(const DispatcherConfig& config, Sink sink)
+    : async_(config.async),
+      maxBatch_(config.maxBatch == 0 ? 1 : config.maxBatch),
+      overflow_(config.overflow),
+      sink_(std::move(sink)),
+      queue_(config.capacity) {}
+
+event_dispatcher::~event_dispatcher() {
+    stop();
+}
+
+void event_dispatcher::start() {
+    if (!async_ || running_.exchange(true)) {
+        return;
+    }
+    thread_ = std::thread(&event_dispatcher::run_, this);
+    thread_tuning::setName(thread_.native_handle(), "ac-dispatch");
+}
+
+std::vector<NamedThread> event_dispatcher::threads() {
+    if (!thread_.joinable()) {
+        return {};
+    }
+    return {{"ac-dispatch", thread_.native_handle()}};
+}
+
+void event_dispatcher::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    wake_();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void event_dispatcher::publish(const EngineEvent& event) {
+    if (!async_) {
+        published_.fetch_add(1, std::memory_order_relaxed);
+        sink_(&event, 1);
+        delivered_.fetch_add(1, std::memory_order_relaxed);
+        batches_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (!queue_.tryPush(event)) {
+        if (overflow_ == DispatchOverflow::Drop || !running_.load(std::memory_order_relaxed)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        backpressureWaits_.fetch_add(1, std::memory_order_relaxed);
+        do {
+            wake_();
+            std::this_thread::yield();
+        } while (!queue_.tryPush(event));
+    }
+    published_.fetch_add(1, std::memory_order_relaxed);
+
+    // Pairs with the fence in run_: either the dispatcher sees the event on its
+    // re-check, or we see it asleep and wake it
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed) != 0) {
+        wake_();
+    }
+}
+
+void event_dispatcher::wake_() {
+    sleeping_.store(0, std::memory_order_relaxed);
+    sleeping_.notify_one();
+}
+
+size_t event_dispatcher::drain_(std::vector<EngineEvent>& batch) {
+    batch.clear();
+    EngineEvent event;
+    while (batch.size() < maxBatch_ && queue_.tryPop(event)) {
+        batch.push_back(event);
+    }
+    if (batch.empty()) {
+        return 0;
+    }
+    try {
+        sink_(batch.data(), batch.size());
+    } catch (const std::exception& e) {
+        AC_LOG_ERROR("Event callback error: {}", e.what());
+    }
+    delivered_.fetch_add(batch.size(), std::memory_order_release);
+    batches_.fetch_add(1, std::memory_order_relaxed);
+    return batch.size();
+}
+
+void event_dispatcher::run_() {
+    std::vector<EngineEvent> batch;
+    batch.reserve(maxBatch_);
+
+    while (running_.load(std::memory_order_acquire)) {
+        if (drain_(batch) != 0) {
+            continue;
+        }
+        sleeping_.store(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (queue_.size() != 0 || !running_.load(std::memory_order_acquire)) {
+            sleeping_.store(0, std::memory_order_relaxed);
+            continue;
+        }
+        sleeping_.wait(1, std::memory_order_relaxed);
+    }
+
+    // Deliver whatever was queued before stop()
+    while (drain_(batch) != 0) {
+    }
+}
+
+void event_dispatcher::flush() {
+    if (!async_) {
+        return;
+    }
+    uint64_t target = published_.load(std::memory_order_acquire);
+    while (running_.load(std::memory_order_acquire) &&
+           delivered_.load(std::memory_order_acquire) < target) {
+        std::this_thread::yield();
+    }
+}
+
+DispatchStats event_dispatcher::stats() const {
+    DispatchStats stats;
+    stats.queueDepth = queue_.size();
+    stats.published = published_.load(std::memory_order_relaxed);
+    stats.delivered = delivered_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.backpressureWaits = backpressureWaits_.load(std::memory_order_relaxed);
+    stats.batches = batches_.load(std::memory_order_relaxed);
+    return stats;
+}
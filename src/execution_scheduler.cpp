@@ -1,92 +1,371 @@
 #include "execution_scheduler.hpp"
-#include <iostream>
+#include "timing_wheel.hpp"
+#include "async_logger.hpp"
+#include <stdexcept>
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
-execution_scheduler::execution_scheduler() = default;
+namespace {
+void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#endif
+}
+}
+
+execution_scheduler::execution_scheduler()
+    : execution_scheduler(SchedulerConfig{}) {}
+
+execution_scheduler::execution_scheduler(const SchedulerConfig& config)
+    : config_(config),
+      clock_(config.clock ? config.clock : std::make_shared<real_clock>()) {
+    if (clock_->isSimulated()) {
+        simulatedClock_ = static_cast<simulated_clock*>(clock_.get());
+    }
+    if (config_.backend == SchedulerBackend::TimingWheel) {
+        tasks_ = std::make_unique<timing_wheel_queue>(config_.wheelTick, clock_->now());
+    } else {
+        tasks_ = std::make_unique<binary_heap_queue>();
+    }
+    // Simulated time runs tasks inline on the caller so event order is deterministic
+    if (config_.workerThreads > 0 && !simulatedClock_) {
+        pool_ = std::make_unique<worker_pool>(config_.workerThreads,
+                                              [this](ScheduledTask& task) { runTask_(task); });
+    }
+#if defined(__linux__)
+    if (config_.wait == SchedulerWait::TimerFd && !simulatedClock_) {
+        timerFd_ = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+        wakeFd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (timerFd_ < 0 || wakeFd_ < 0) {
+            throw std::runtime_error("Could not create the scheduler's timerfd");
+        }
+    }
+#endif
+}
 
 execution_scheduler::~execution_scheduler(){
     stop();
+#if defined(__linux__)
+    if (timerFd_ >= 0) {
+        close(timerFd_);
+    }
+    if (wakeFd_ >= 0) {
+        close(wakeFd_);
+    }
+#endif
 }
 
 void execution_scheduler::start(){
     if(running_.exchange(true)){
         return; // already running
     }
+    if (simulatedClock_) {
+        return; // driven by runUntil()
+    }
+    if (pool_) {
+        pool_->start();
+    }
     workerThread_ = std::thread(&execution_scheduler::workerThread, this);
+    thread_tuning::setName(workerThread_.native_handle(), "ac-timer");
+}
+
+std::vector<NamedThread> execution_scheduler::threads() {
+    std::vector<NamedThread> threads;
+    if (workerThread_.joinable()) {
+        threads.push_back({"ac-timer", workerThread_.native_handle()});
+    }
+    if (pool_) {
+        auto workers = pool_->threads();
+        threads.insert(threads.end(), workers.begin(), workers.end());
+    }
+    return threads;
 }
 
 void execution_scheduler::stop(){
-    if(running_.exchange(false)){
-        return;
+    if(!running_.exchange(false)){
+        return; // not running
+    }
+    {
+        std::lock_guard lock(queueMutex_); // don't lose the wakeup against a worker about to wait
+        wake_(TimePoint::min());
     }
     condition_.notify_all();
     if(workerThread_.joinable()){
         workerThread_.join();
     }
+    if (pool_) {
+        pool_->stop();
+    }
+}
+
+TaskHandle execution_scheduler::scheduleAt(const TimePoint& time, Task task, uint64_t affinityKey){
+    return addTask(time, std::move(task), std::chrono::nanoseconds(0), affinityKey);
+}
+
+TaskHandle execution_scheduler::scheduleAfter(const std::chrono::nanoseconds& delay, Task task, uint64_t affinityKey){
+    auto time = clock_->now() + std::chrono::duration_cast<TimePoint::duration>(delay);
+    return scheduleAt(time, std::move(task), affinityKey);
 }
 
-void execution_scheduler::scheduleAt(const TimePoint& time, Task task){
-    addTask(ScheduledTask{time, std::move(task)});
+TaskHandle execution_scheduler::scheduleEvery(const std::chrono::nanoseconds& interval, Task task, uint64_t affinityKey){
+    if (interval.count() <= 0) {
+        throw std::invalid_argument("scheduleEvery needs a positive interval");
+    }
+    auto now = clock_->now();
+    return addTask(now, std::move(task), interval, affinityKey);
 }
 
-void execution_scheduler::scheduleAfter(const std::chrono::milliseconds& delay, Task task){
-    auto time = std::chrono::steady_clock::now() + delay;
-    scheduleAt(time, std::move(task));
+TaskHandle execution_scheduler::addTask(const TimePoint& time, Task task,
+                                        std::chrono::nanoseconds interval, uint64_t affinityKey){
+    auto state = std::make_shared<TaskState>();
+    state->task = std::move(task);
+    state->interval = interval;
+    state->affinity = affinityKey;
+    {
+        std::lock_guard lock(queueMutex_);
+        tasks_->push(ScheduledTask{time, state, 0, interval, affinityKey});
+        wake_(time);
+    }
+    condition_.notify_one();
+    return TaskHandle(std::move(state));
 }
 
-void execution_scheduler::scheduleEvery(const std::chrono::milliseconds& interval, Task task){
-    auto now = std::chrono::steady_clock::now();
-    ScheduledTask scheduledTask{now, std::move(task), interval};
-    addTask(scheduledTask); 
+bool execution_scheduler::cancel(const TaskHandle& handle){
+    if (!handle.state_) {
+        return false;
+    }
+    std::lock_guard lock(queueMutex_);
+    TaskState& state = *handle.state_;
+    state.stopRequested = true;
+    if (state.token.load(std::memory_order_relaxed) >= TaskState::kCancelled) {
+        return false; // already dispatched or cancelled
+    }
+    state.token.store(TaskState::kCancelled, std::memory_order_relaxed);
+    markStale_();
+    return true;
 }
 
-void execution_scheduler::addTask(const ScheduledTask& task){
+bool execution_scheduler::reschedule(const TaskHandle& handle, const TimePoint& time){
+    if (!handle.state_) {
+        return false;
+    }
     {
         std::lock_guard lock(queueMutex_);
-        tasks_.push(task);
+        TaskState& state = *handle.state_;
+        uint64_t token = state.token.load(std::memory_order_relaxed);
+        if (token >= TaskState::kCancelled) {
+            return false;
+        }
+        // Supersede the queued entry rather than searching for it
+        uint64_t generation = state.nextGeneration++;
+        state.token.store(generation, std::memory_order_relaxed);
+        markStale_();
+        tasks_->push(ScheduledTask{time, handle.state_, generation,
+                                   state.interval, state.affinity});
+        wake_(time);
     }
     condition_.notify_one();
+    return true;
+}
+
+void execution_scheduler::markStale_(){
+    ++staleEntries_;
+    // Rebuild once dead entries outnumber live ones: amortized O(1) per cancel
+    if (staleEntries_ > 64 && staleEntries_ * 2 > tasks_->size()) {
+        size_t removed = tasks_->purgeStale();
+        staleEntries_ -= std::min(staleEntries_, removed);
+    }
+}
+
+void execution_scheduler::claimLive_(std::vector<ScheduledTask>& due){
+    // Drop cancelled/superseded entries; claim the live ones so cancel() now fails
+    size_t live = 0;
+    for(auto& entry : due){
+        if(entry.isLive()){
+            entry.state->token.store(TaskState::kDispatched, std::memory_order_relaxed);
+            if(&due[live] != &entry){
+                due[live] = std::move(entry);
+            }
+            ++live;
+        } else if (staleEntries_ > 0) {
+            --staleEntries_;
+        }
+    }
+    due.resize(live);
+}
+
+size_t execution_scheduler::runUntil(const TimePoint& limit){
+    if (!simulatedClock_) {
+        throw std::logic_error("runUntil() requires a simulated clock");
+    }
+
+    size_t executed = 0;
+    std::vector<ScheduledTask> due;
+    while (true) {
+        {
+            std::lock_guard lock(queueMutex_);
+            tasks_->popDue(clock_->now(), due);
+            claimLive_(due);
+            if (due.empty()) {
+                if (tasks_->empty()) {
+                    break;
+                }
+                TimePoint next = tasks_->nextDeadline();
+                if (next > limit) {
+                    simulatedClock_->advanceTo(limit);
+                    break;
+                }
+                simulatedClock_->advanceTo(next); // jump straight to the next event
+                continue;
+            }
+        }
+        for (auto& task : due) {
+            runTask_(task);
+            ++executed;
+        }
+        due.clear();
+    }
+    return executed;
 }
 
 size_t execution_scheduler::pendingTasks() const {
     std::lock_guard lock(queueMutex_);
-    return tasks_.size();
+    return tasks_->size() - std::min(staleEntries_, tasks_->size());
 }
 
 void execution_scheduler::workerThread(){
-    std::cout << "Worker thread STARTED" << std::endl;
+    AC_LOG_DEBUG("Scheduler timer thread started");
+    std::vector<ScheduledTask> due; // reused across iterations
     while(running_){
         std::unique_lock lock(queueMutex_);
 
-        if(tasks_.empty()){
-            condition_.wait(lock, [this]() {return !tasks_.empty() || !running_; }); // only wake up when tasks exit or shutdown required 
+        if(tasks_->empty()){
+            condition_.wait(lock, [this]() {return !tasks_->empty() || !running_; }); // only wake up when tasks exit or shutdown required 
             continue;
         }
 
-        auto nextTask = tasks_.top();
-        auto now = std::chrono::steady_clock::now();
+        auto now = clock_->now();
+        tasks_->popDue(now, due);
 
-        if(nextTask.executionTime <= now){
-            //Execute task
-            tasks_.pop();
-            lock.unlock(); // Other threads can submit tasks immediately
+        claimLive_(due);
 
-            try{
-                nextTask.task();
-            } catch (const std::exception& e){
-                std::cerr <<"Task execution error: " << e.what() << std::endl;
+        if(due.empty()){
+            if(!tasks_->empty()){
+                waitUntil_(lock, tasks_->nextDeadline());
             }
+            continue;
+        }
+        lock.unlock(); // Other threads can submit tasks immediately
 
-            //reschedule task if its recurring
-            if (nextTask.isRecurring()){
-                ScheduledTask newTask{
-                    now + nextTask.interval,
-                    nextTask.task,
-                    nextTask.interval
-                };
-                addTask(newTask);
+        for(auto& nextTask : due){
+            if (pool_) {
+                pool_->submit(std::move(nextTask));
+            } else {
+                runTask_(nextTask);
             }
-        } else {
-            condition_.wait_until(lock, nextTask.executionTime);
         }
+        due.clear();
+    }
+}
+
+void execution_scheduler::wake_(TimePoint time){
+    queueChanges_.fetch_add(1, std::memory_order_release);
+#if defined(__linux__)
+    // Only work due before what the poll is armed for needs to interrupt it
+    if (wakeFd_ >= 0 && time < armedDeadline_) {
+        uint64_t one = 1;
+        [[maybe_unused]] ssize_t written = write(wakeFd_, &one, sizeof(one));
     }
-}
\ No newline at end of file
+#else
+    (void)time;
+#endif
+}
+
+void execution_scheduler::waitUntil_(std::unique_lock<std::mutex>& lock, TimePoint deadline){
+#if defined(__linux__)
+    if (timerFd_ >= 0) {
+        int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+        itimerspec spec{};
+        spec.it_value.tv_sec = ns / 1'000'000'000;
+        spec.it_value.tv_nsec = ns % 1'000'000'000;
+        if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) {
+            spec.it_value.tv_nsec = 1; // all zero would disarm the timer
+        }
+        timerfd_settime(timerFd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+        armedDeadline_ = deadline;
+        lock.unlock();
+        pollfd fds[2] = {{timerFd_, POLLIN, 0}, {wakeFd_, POLLIN, 0}};
+        poll(fds, 2, -1);
+        uint64_t count;
+        for (const pollfd& fd : fds) {
+            if (fd.revents & POLLIN) {
+                [[maybe_unused]] ssize_t got = read(fd.fd, &count, sizeof(count));
+            }
+        }
+        lock.lock();
+        armedDeadline_ = TimePoint::max();
+        return;
+    }
+#endif
+    if (config_.wait != SchedulerWait::SleepSpin) {
+        condition_.wait_until(lock, deadline);
+        return;
+    }
+    auto spinFrom = deadline - std::chrono::duration_cast<TimePoint::duration>(config_.spinWindow);
+    if (clock_->now() < spinFrom) {
+        condition_.wait_until(lock, spinFrom);
+        return; // the caller looks at the queue again, then spins if nothing changed
+    }
+    // Spin out the last stretch without the lock; new work ends it early
+    uint64_t seen = queueChanges_.load(std::memory_order_acquire);
+    lock.unlock();
+    while (clock_->now() < deadline && queueChanges_.load(std::memory_order_acquire) == seen) {
+        cpuRelax();
+    }
+    lock.lock();
+}
+
+void execution_scheduler::runTask_(ScheduledTask& nextTask){
+    auto now = clock_->now();
+    dispatchLag_.record(now - nextTask.executionTime);
+    TaskState& state = *nextTask.state;
+    auto started = std::chrono::steady_clock::now();
+    try{
+        state.task();
+    } catch (const std::exception& e){
+        AC_LOG_ERROR("Task execution error: {}", e.what());
+    }
+    runTime_.record(std::chrono::steady_clock::now() - started);
+
+    if (!nextTask.isRecurring()){
+        return;
+    }
+
+    //reschedule task if its recurring and nobody cancelled it mid-run
+    {
+        std::lock_guard lock(queueMutex_);
+        if (state.stopRequested || !running_){
+            state.token.store(TaskState::kCancelled, std::memory_order_relaxed);
+            return;
+        }
+        // Anchored to the deadline, not to when the run started or ended
+        TimePoint next = nextTask.executionTime + nextTask.interval;
+        auto finished = clock_->now();
+        if (next <= finished) {
+            next += nextTask.interval * ((finished - next) / nextTask.interval + 1);
+        }
+        uint64_t generation = state.nextGeneration++;
+        state.token.store(generation, std::memory_order_relaxed);
+        tasks_->push(ScheduledTask{next, nextTask.state, generation,
+                                   nextTask.interval, nextTask.affinity});
+        wake_(next);
+    }
+    condition_.notify_one();
+}
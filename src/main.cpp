@@ -1,15 +1,25 @@
 #include "trading_engine.hpp"
+#include "async_logger.hpp"
 #include <iostream>
 #include <thread>
 #include <chrono>
 #include <iomanip>
+#include <string>
+
+int main(int argc, char** argv) {
+    // --simulated: run on a virtual clock so the whole order completes immediately
+    bool simulated = argc > 1 && std::string(argv[1]) == "--simulated";
 
-int main() {
     std::cout << "=== ALMGREN-CHRISS TRADING ENGINE DEMO ===" << std::endl;
     std::cout << "Starting execution..." << std::endl;
     
     try {
-        TradingEngine engine;
+        EngineConfig config;
+        if (simulated) {
+            config.scheduler.clock = std::make_shared<simulated_clock>();
+            config.modelSeed = 42;
+        }
+        TradingEngine engine(config);
         engine.initialize();
         
         // Create a sell order
@@ -34,9 +44,15 @@ int main() {
         
         engine.startExecution(orderId);
         
+        if (simulated) {
+            size_t events = engine.runSimulation();
+            async_logger::instance().flush(); // engine log lines before our summary
+            std::cout << "\n Simulated " << events << " scheduled events" << std::endl;
+        }
+        
         // Monitor execution progress
         std::cout << "\n Monitoring execution..." << std::endl;
-        for (int i = 0; i < 15; ++i) {
+        for (int i = 0; i < 15 && !simulated; ++i) {
             std::this_thread::sleep_for(std::chrono::seconds(10));
             
             auto status = engine.getOrderStatus(orderId);
@@ -51,6 +67,7 @@ int main() {
                 case OrderStatus::ACTIVE: std::cout << "ACTIVE"; break;
                 case OrderStatus::COMPLETED: std::cout << "COMPLETED"; break;
                 case OrderStatus::CANCELLED: std::cout << "CANCELLED"; break;
+                case OrderStatus::FAILED: std::cout << "FAILED"; break;
                 default: std::cout << "UNKNOWN"; break;
             }
             std::cout << " | Remaining chunks: " << remaining.size() << std::endl;
@@ -63,6 +80,7 @@ int main() {
         
         // Get final metrics
         auto finalMetrics = engine.getOrderMetrics(orderId);
+        async_logger::instance().flush();
         std::cout << "\n FINAL EXECUTION METRICS:" << std::endl;
         std::cout << "Total Shares: " << finalMetrics.totalShares << std::endl;
         std::cout << "Executed Shares: " << finalMetrics.executedShares << std::endl;
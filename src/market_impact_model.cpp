@@ -1,40 +1,36 @@
 #include "market_impact_model.hpp"
+#include "async_logger.hpp"
 #include <cmath>
 #include <stdexcept>
 #include <random>
+#include <atomic>
 #include <iostream>
 #include <format>
 
-// Initialize static random members
-std::random_device AlmgrenChrissModel::rd_{};
-std::mt19937 AlmgrenChrissModel::rng_{AlmgrenChrissModel::rd_()};
-std::normal_distribution<double> AlmgrenChrissModel::norm_{0.0, 1.0};
-
 void AlmgrenChrissModel::updateDerivedParameters_(){
     if(eta_ <= 0 || lambda_ < 0 || timeHorizon_ <= 0){
         throw std::invalid_argument("Invalid parameters: eta, lambda, timeHorizon must be positive");
     }
     
-    // Handle risk-neutral case (lambda = 0)
-    if (lambda_ == 0.0) {
-        kappa_ = 0.0;
-        sinhKappaT_ = 0.0;
-        coshKappaT_ = 1.0;
+    // Risk-neutral (lambda = 0) gives kappa = 0: a straight-line TWAP
+    kappa_ = std::sqrt(lambda_ * sigma_ * sigma_ / eta_);
+    if (std::isnan(kappa_) || std::isinf(kappa_)) {
+        throw std::invalid_argument("Invalid kappa calculation - check parameters");
+    }
+
+    trajectory_ = trajectory::Params::make(kappa_, timeHorizon_, totalShares_);
+    if (trajectory_.shape == trajectory::Shape::Linear) {
+        remainingAt_ = &trajectory::remainingAt<trajectory::Shape::Linear>;
+        rateAt_ = &trajectory::rateAt<trajectory::Shape::Linear>;
     } else {
-        kappa_ = std::sqrt(lambda_ * sigma_ * sigma_ / eta_);
-        std::cout << "value of kappa" << kappa_ << std::endl;
-        // Check for valid kappa before calculating hyperbolic functions
-        if (std::isnan(kappa_) || std::isinf(kappa_)) {
-            throw std::invalid_argument("Invalid kappa calculation - check parameters");
-        }
-        sinhKappaT_ = std::sinh(kappa_ * timeHorizon_);
-        coshKappaT_ = std::cosh(kappa_ * timeHorizon_);
+        remainingAt_ = &trajectory::remainingAt<trajectory::Shape::Hyperbolic>;
+        rateAt_ = &trajectory::rateAt<trajectory::Shape::Hyperbolic>;
     }
 
     reset();
     
-    std::cout << "Derived params: κ=" << kappa_ << ", sinh(κT)=" << sinhKappaT_ 
-              << ", cosh(κT)=" << coshKappaT_ << std::endl;
+    AC_LOG_DEBUG("Derived params: kappa={} kappa*T={} linear={}", kappa_, kappa_ * timeHorizon_,
+                 trajectory_.shape == trajectory::Shape::Linear);
 }
 
 void AlmgrenChrissModel::setParameters(double sigma, double gamma, double eta, double lambda,
@@ -60,88 +56,67 @@ void AlmgrenChrissModel::setParameters(double sigma, double gamma, double eta, d
 
     updateDerivedParameters_();
     
-    std::cout << "Model params: σ=" << sigma_ << " γ=" << gamma_ 
-              << " η=" << eta_ << " λ=" << lambda_ << " S₀=" << initialPrice_ 
-              << " X=" << totalShares_ << " T=" << timeHorizon_ << std::endl;
+    AC_LOG_DEBUG("Model params: sigma={} gamma={} eta={} lambda={} S0={} X={} T={}",
+                 sigma_, gamma_, eta_, lambda_, initialPrice_, totalShares_, timeHorizon_);
 }
 
 double AlmgrenChrissModel::computeRemainingShares(double t) const {
     if (t < 0 || t > timeHorizon_) {
         throw std::out_of_range(std::format("Time must be in [0, {}], got {}", timeHorizon_, t));
     }
-    
-    if (lambda_ == 0.0 || kappa_ == 0.0) {
-        return totalShares_ * (1.0 - t / timeHorizon_);
-    }
-    
-    // Handle very small kappaT to avoid numerical issues
-    if (std::abs(kappa_ * timeHorizon_) < 1e-10) {
-        return totalShares_ * (1.0 - t / timeHorizon_);
-    }
-    
-    double result = totalShares_ * std::sinh(kappa_ * (timeHorizon_ - t)) / sinhKappaT_;
-    
-    // Ensure result is valid
-    if (std::isnan(result) || std::isinf(result)) {
-        return totalShares_ * (1.0 - t / timeHorizon_); // Fallback to linear
-    }
-    
-    return std::max(0.0, std::min(totalShares_, result));
+    return remainingAt_(trajectory_, t);
 }
 
 double AlmgrenChrissModel::computeTradingRate(double t) const {
     if (t < 0 || t > timeHorizon_) {
         throw std::out_of_range(std::format("Time must be in [0, {}], got {}", timeHorizon_, t));
     }
-    
-    // Handle risk-neutral case (lambda = 0) - constant rate
-    if (lambda_ == 0.0 || kappa_ == 0.0) {
-        return totalShares_ / timeHorizon_;
-    }
-    
-    // Handle very small kappaT to avoid numerical issues
-    if (std::abs(kappa_ * timeHorizon_) < 1e-10) {
-        return totalShares_ / timeHorizon_;
+    return rateAt_(trajectory_, t);
+}
+
+void AlmgrenChrissModel::computeRemainingShares(std::span<const double> times, std::span<double> out) const {
+    if (times.size() != out.size()) {
+        throw std::invalid_argument("computeRemainingShares: times and out differ in size");
     }
-    
-    double result = totalShares_ * kappa_ * std::cosh(kappa_ * (timeHorizon_ - t)) / sinhKappaT_;
-    
-    // Ensure result is valid
-    if (std::isnan(result) || std::isinf(result)) {
-        return totalShares_ / timeHorizon_; // Fallback to constant rate
+    trajectory::remainingShares(trajectory_, times.data(), out.data(), times.size());
+}
+
+void AlmgrenChrissModel::computeTradingRate(std::span<const double> times, std::span<double> out) const {
+    if (times.size() != out.size()) {
+        throw std::invalid_argument("computeTradingRate: times and out differ in size");
     }
-    
-    return std::max(0.0, result);
+    trajectory::tradingRate(trajectory_, times.data(), out.data(), times.size());
 }
 
 std::vector<double> AlmgrenChrissModel::calculateOptimalSchedule(int intervals) {
-    std::vector<double> schedule;
-    schedule.reserve(intervals);
-    
-    double timeStep = timeHorizon_ / intervals;
-    
-    for (int i = 0; i < intervals; ++i) {
-        double t_start = i * timeStep;
-        double t_end = (i + 1) * timeStep;
-        
-        double shares_at_start = computeRemainingShares(t_start);
-        double shares_at_end = computeRemainingShares(t_end);
-        double shares_to_trade = shares_at_start - shares_at_end;
-        
-        schedule.push_back(std::max(0.0, shares_to_trade));
+    if (intervals <= 0) {
+        throw std::invalid_argument("calculateOptimalSchedule needs a positive interval count");
     }
+    std::vector<double> schedule(intervals);
+    trajectory::schedule(trajectory_, intervals, schedule.data());
     
-    std::cout << "Optimal schedule (" << intervals << " intervals): ";
-    double total = 0.0;
-    for (double shares : schedule) {
-        std::cout << static_cast<int>(shares) << " ";
-        total += shares;
-    }
-    std::cout << " | Total: " << static_cast<int>(total) << std::endl;
+    AC_LOG_DEBUG("Optimal schedule: {} intervals, first {} last {}",
+                 intervals, schedule.empty() ? 0.0 : schedule.front(), schedule.empty() ? 0.0 : schedule.back());
     
     return schedule;
 }
 
+std::vector<double> AlmgrenChrissModel::remainingSchedule(double remainingShares, double remainingTime,
+                                                        int intervals, double sigma, double eta) const {
+    if (intervals <= 0 || remainingTime <= 0 || eta <= 0 || sigma <= 0) {
+        throw std::invalid_argument("remainingSchedule needs positive intervals, time, sigma and eta");
+    }
+
+    std::vector<double> schedule(intervals, 0.0);
+    double kappa = std::sqrt(lambda_ * sigma * sigma / eta);
+    trajectory::schedule(trajectory::Params::make(kappa, remainingTime, remainingShares), intervals, schedule.data());
+    return schedule;
+}
+
+std::vector<double> AlmgrenChrissModel::scheduleShape(int intervals) const {
+    return remainingSchedule(1.0, timeHorizon_, intervals, sigma_, eta_);
+}
+
 double AlmgrenChrissModel::simulatePriceStep(double dt){
     if (elapsedTime_ >= timeHorizon_) {
         return currentPrice_; // Already finished
@@ -151,11 +126,26 @@ double AlmgrenChrissModel::simulatePriceStep(double dt){
         dt = timeHorizon_ - elapsedTime_; // don't overshoot the horizon
     }
 
+    // Price update: dS = -γ v dt + σ dW
     double v = computeTradingRate(elapsedTime_);
-    const double dW = norm_(rng_) * std::sqrt(dt);
+    return step_(dt, -gamma_ * v * dt);
+}
 
-    // Price update: dS = -γ v dt + σ dW
-    double permanentImpact = -gamma_ * v * dt ; // Scale for reasonable impact
+double AlmgrenChrissModel::simulatePriceStep(double dt, double signedShares){
+    if (elapsedTime_ >= timeHorizon_) {
+        return currentPrice_; // Already finished
+    }
+
+    if (elapsedTime_ + dt > timeHorizon_) {
+        dt = timeHorizon_ - elapsedTime_;
+    }
+
+    // dS = γ n + σ dW for n shares traded in the step, signed by side
+    return step_(dt, gamma_ * signedShares);
+}
+
+double AlmgrenChrissModel::step_(double dt, double permanentImpact){
+    const double dW = nextNormal_() * std::sqrt(dt);
     double randomWalk = sigma_ * dW;
     currentPrice_ *= (1.0 + randomWalk);
     currentPrice_ += permanentImpact;
@@ -163,10 +153,52 @@ double AlmgrenChrissModel::simulatePriceStep(double dt){
     if (currentPrice_ <= 0.0){
         throw std::runtime_error("Price became negative - check parameters");
     }
+
+    elapsedTime_ += dt;
     
     return currentPrice_;
 }
 
+uint64_t AlmgrenChrissModel::defaultSeed_() {
+    // random_device is read once per process (it can cost a syscall); every
+    // model after that gets a distinct splitmix64 output from a counter
+    static const uint64_t base = (uint64_t{std::random_device{}()} << 32) | std::random_device{}();
+    static std::atomic<uint64_t> counter{0};
+    uint64_t z = base + counter.fetch_add(1, std::memory_order_relaxed) * 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+void AlmgrenChrissModel::seed(uint64_t seed, uint64_t stream) {
+    rng_.seed(seed, stream);
+    normalIndex_ = kNormalBatch;
+}
+
+void AlmgrenChrissModel::skipDraws(uint64_t steps) {
+    if (steps <= kNormalBatch - normalIndex_) {
+        normalIndex_ += static_cast<uint32_t>(steps);
+        return;
+    }
+    // Draw index in the stream; the buffer ends where the generator stands
+    const uint64_t target = 2 * rng_.block() - (kNormalBatch - normalIndex_) + steps;
+    rng_.seek(target / 2);
+    refillNormals_();
+    normalIndex_ = static_cast<uint32_t>(target % 2);
+}
+
+double AlmgrenChrissModel::nextNormal_() {
+    if (normalIndex_ == kNormalBatch) {
+        refillNormals_();
+    }
+    return normals_[normalIndex_++];
+}
+
+void AlmgrenChrissModel::refillNormals_() {
+    rng_.fillNormal(normals_);
+    normalIndex_ = 0;
+}
+
 void AlmgrenChrissModel::reset() {
     elapsedTime_ = 0.0;
     executedShares_ = 0.0;
@@ -178,4 +210,4 @@ void AlmgrenChrissModel::printState() const {
         "State: t={:.2f}/{:.2f}, x(t)={:.0f}/{:.0f}, S(t)={:.2f}", 
         elapsedTime_, timeHorizon_, executedShares_, totalShares_, currentPrice_
     ) << std::endl;
-}
\ No newline at end of file
+}
\ No newline at end of file
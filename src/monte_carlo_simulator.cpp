@@ -0,0 +1,122 @@
+#include "monte_carlo_simulator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+
+double MonteCarloResult::quantile(double level) const {
+    for (const auto& [q, cost] : quantiles) {
+        if (q == level) {
+            return cost;
+        }
+    }
+    throw std::out_of_range("Quantile level was not requested");
+}
+
+MonteCarloSimulator::MonteCarloSimulator(unsigned threads)
+    : threads_(threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads) {}
+
+double MonteCarloSimulator::simulatePath_(AlmgrenChrissModel& model, const std::vector<double>& schedule,
+                                          double tau, bool isBuy) {
+    const double side = isBuy ? 1.0 : -1.0;
+    double totalShares = 0.0;
+    for (double shares : schedule) {
+        totalShares += shares;
+    }
+    const double arrivalValue = model.getInitialPrice() * totalShares;
+
+    model.reset();
+    double tradedValue = 0.0;
+    for (double shares : schedule) {
+        // Interval k trades at the price it starts from, S_{k-1}, plus temporary
+        // impact eta * rate; its own shares then move the price permanently
+        // (gamma per share, with the side) along with the shock
+        double price = model.getCurrentPrice() + side * model.getEta() * (shares / tau);
+        tradedValue += shares * price;
+        model.simulatePriceStep(tau, side * shares);
+    }
+
+    return side * (tradedValue - arrivalValue);
+}
+
+MonteCarloResult MonteCarloSimulator::run(const AlmgrenChrissModel& model,
+                                          const std::vector<double>& schedule,
+                                          size_t paths,
+                                          bool isBuy,
+                                          uint64_t seed,
+                                          const std::vector<double>& quantileLevels) const {
+    if (schedule.empty()) {
+        throw std::invalid_argument("Schedule must not be empty");
+    }
+    for (double level : quantileLevels) {
+        if (level < 0.0 || level > 1.0) {
+            throw std::invalid_argument("Quantile levels must be in [0, 1]");
+        }
+    }
+
+    MonteCarloResult result;
+    result.paths = paths;
+    if (paths == 0) {
+        return result;
+    }
+
+    const double tau = model.getTimeHorizon() / static_cast<double>(schedule.size());
+    const unsigned workers = static_cast<unsigned>(std::min<size_t>(threads_, paths));
+
+    std::vector<double> costs(paths);
+    std::vector<std::exception_ptr> errors(workers);
+    std::vector<std::thread> pool;
+    pool.reserve(workers);
+
+    // Contiguous block of paths per worker; each writes only its own slice of `costs`
+    for (unsigned w = 0; w < workers; ++w) {
+        const size_t begin = paths * w / workers;
+        const size_t end = paths * (w + 1) / workers;
+        pool.emplace_back([&, w, begin, end]() {
+            try {
+                AlmgrenChrissModel local = model;
+                for (size_t i = begin; i < end; ++i) {
+                    local.seed(seed, i);
+                    costs[i] = simulatePath_(local, schedule, tau, isBuy);
+                }
+            } catch (...) {
+                errors[w] = std::current_exception();
+            }
+        });
+    }
+    for (auto& t : pool) {
+        t.join();
+    }
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    double sum = 0.0;
+    for (double c : costs) {
+        sum += c;
+    }
+    result.mean = sum / static_cast<double>(paths);
+
+    double sq = 0.0;
+    for (double c : costs) {
+        sq += (c - result.mean) * (c - result.mean);
+    }
+    result.variance = paths > 1 ? sq / static_cast<double>(paths - 1) : 0.0;
+    result.stdDev = std::sqrt(result.variance);
+
+    // Linear interpolation between order statistics
+    std::sort(costs.begin(), costs.end());
+    result.quantiles.reserve(quantileLevels.size());
+    for (double level : quantileLevels) {
+        double pos = level * static_cast<double>(paths - 1);
+        size_t lo = static_cast<size_t>(std::floor(pos));
+        size_t hi = std::min(lo + 1, paths - 1);
+        double frac = pos - static_cast<double>(lo);
+        result.quantiles.emplace_back(level, costs[lo] + frac * (costs[hi] - costs[lo]));
+    }
+
+    return result;
+}
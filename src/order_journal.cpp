@@ -0,0 +1,516 @@
+#include "order_journal.hpp"
+#include "async_logger.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+constexpr char kSegmentMagic[8] = {'A', 'C', 'J', 'R', 'N', 'L', '\0', '\0'};
+constexpr char kSnapshotMagic[8] = {'A', 'C', 'S', 'N', 'A', 'P', '\0', '\0'};
+constexpr std::string_view kSegmentPrefix = "journal.";
+constexpr std::string_view kSnapshotPrefix = "snapshot.";
+
+size_t paddedSize(size_t payload) {
+    return (sizeof(JournalRecordHeader) + payload + 7) & ~size_t{7};
+}
+
+size_t pageSize() {
+    static const size_t size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+// 64-bit multiply-xor over whole words (FNV-1a's step, eight bytes at a
+// time): a torn or stale record fails it, and it keeps up with memcpy
+uint32_t checksum(const JournalRecordHeader& header, const char* payload) {
+    constexpr uint64_t kPrime = 0x100000001b3ull;
+    uint64_t hash = 0xcbf29ce484222325ull;
+    auto mix = [&](uint64_t word) { hash = (hash ^ word) * kPrime; };
+
+    uint64_t word;
+    std::memcpy(&word, &header, 8);  // length, type, reserved
+    mix(word);
+    mix(uint64_t{header.handle});
+    mix(header.sequence);
+    size_t i = 0;
+    for (; i + 8 <= header.length; i += 8) {
+        std::memcpy(&word, payload + i, 8);
+        mix(word);
+    }
+    if (i < header.length) {
+        word = 0;
+        std::memcpy(&word, payload + i, header.length - i);
+        mix(word);
+    }
+    return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+std::string fileName(std::string_view prefix, uint64_t number) {
+    std::string digits = std::to_string(number);
+    return std::string(prefix) + std::string(digits.size() < 12 ? 12 - digits.size() : 0, '0') + digits;
+}
+
+// Number from "journal.<n>" / "snapshot.<n>", or 0 if name is something else
+uint64_t fileNumber(const std::string& name, std::string_view prefix) {
+    if (name.compare(0, prefix.size(), prefix) != 0) {
+        return 0;
+    }
+    uint64_t number = 0;
+    const char* last = name.data() + name.size();
+    auto [ptr, ec] = std::from_chars(name.data() + prefix.size(), last, number);
+    return ec == std::errc{} && ptr == last ? number : 0;
+}
+
+std::vector<uint64_t> listFiles(const std::string& directory, std::string_view prefix) {
+    std::vector<uint64_t> numbers;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        if (uint64_t number = fileNumber(entry.path().filename().string(), prefix)) {
+            numbers.push_back(number);
+        }
+    }
+    std::sort(numbers.begin(), numbers.end());
+    return numbers;
+}
+
+void syncDirectory(const std::string& directory) {
+    int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+}
+
+// Read-only view of a whole journal or snapshot file
+class mapped_file {
+public:
+    explicit mapped_file(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open journal file: " + path);
+        }
+        struct stat st{};
+        if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(JournalFileHeader)) {
+            ::close(fd);
+            throw std::runtime_error("Journal file too small: " + path);
+        }
+        length_ = static_cast<size_t>(st.st_size);
+        void* data = ::mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            throw std::runtime_error("mmap failed for journal file: " + path);
+        }
+        ::madvise(data, length_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(data);
+    }
+    ~mapped_file() { ::munmap(const_cast<char*>(data_), length_); }
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    const char* data() const { return data_; }
+    size_t size() const { return length_; }
+    const JournalFileHeader& header() const { return *reinterpret_cast<const JournalFileHeader*>(data_); }
+
+private:
+    const char* data_{nullptr};
+    size_t length_{0};
+};
+
+// Older files encode records differently; replaying them would misread fills
+void checkVersion(const JournalFileHeader& header, const std::string& path) {
+    if (header.version != kJournalVersion) {
+        throw std::runtime_error("Journal file " + path + " has version " + std::to_string(header.version) +
+                                 ", this build reads version " + std::to_string(kJournalVersion));
+    }
+}
+
+// Walks the records of [begin, end), counting records and bytes; returns
+// false if it stopped at a torn record rather than the end marker or the end
+// of the range
+template <typename Fn>
+bool forEachRecord(const char* begin, const char* end, uint64_t& count, uint64_t& bytes, Fn&& fn) {
+    const char* at = begin;
+    while (end - at >= static_cast<ptrdiff_t>(sizeof(JournalRecordHeader))) {
+        JournalRecordHeader header;
+        std::memcpy(&header, at, sizeof(header));
+        if (header.length == 0 && header.type == 0) {
+            return true; // never written
+        }
+        size_t size = paddedSize(header.length);
+        if (static_cast<size_t>(end - at) < size) {
+            return false;
+        }
+        const char* payload = at + sizeof(header);
+        if (checksum(header, payload) != header.checksum) {
+            return false;
+        }
+        fn(JournalRecord{static_cast<JournalRecordType>(header.type), header.handle, header.sequence,
+                         payload, header.length});
+        ++count;
+        bytes += size;
+        at += size;
+    }
+    return true;
+}
+} // namespace
+
+struct order_journal::Segment {
+    uint64_t number{0};
+    int fd{-1};
+    char* base{nullptr};
+    size_t capacity{0};
+    size_t used{0};    // under mutex_
+    size_t synced{0};  // under flushMutex_
+
+    ~Segment() {
+        if (base) {
+            ::munmap(base, capacity);
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+};
+
+void order_journal::batch::add(JournalRecordType type, OrderHandle handle, uint64_t sequence,
+                               const void* payload, size_t length) {
+    add(type, handle, sequence, {{payload, length}});
+}
+
+void order_journal::batch::add(JournalRecordType type, OrderHandle handle, uint64_t sequence,
+                               std::initializer_list<std::pair<const void*, size_t>> parts) {
+    size_t length = 0;
+    for (const auto& part : parts) {
+        length += part.second;
+    }
+    size_t offset = bytes_.size();
+    bytes_.resize(offset + paddedSize(length)); // zero padding keeps the file reproducible
+
+    JournalRecordHeader header{};
+    header.length = static_cast<uint32_t>(length);
+    header.type = static_cast<uint16_t>(type);
+    header.handle = handle;
+    header.sequence = sequence;
+    char* payload = bytes_.data() + offset + sizeof(header);
+    for (const auto& part : parts) {
+        if (part.second > 0) {
+            std::memcpy(payload, part.first, part.second);
+            payload += part.second;
+        }
+    }
+    header.checksum = checksum(header, bytes_.data() + offset + sizeof(header));
+    std::memcpy(bytes_.data() + offset, &header, sizeof(header));
+    ++records_;
+}
+
+order_journal::order_journal(const JournalConfig& config)
+    : config_(config) {
+    if (config_.directory.empty()) {
+        throw std::invalid_argument("Journal directory must not be empty");
+    }
+    std::filesystem::create_directories(config_.directory);
+
+    uint64_t last = 0;
+    for (std::string_view prefix : {kSegmentPrefix, kSnapshotPrefix}) {
+        auto numbers = listFiles(config_.directory, prefix);
+        if (!numbers.empty()) {
+            last = std::max(last, numbers.back());
+        }
+    }
+    nextSegment_ = last + 1;
+    {
+        std::lock_guard lock(mutex_);
+        openSegment_(nextSegment_++, 0);
+    }
+    flusher_ = std::thread(&order_journal::flusherLoop_, this);
+    thread_tuning::setName(flusher_.native_handle(), "ac-journal");
+}
+
+std::vector<NamedThread> order_journal::threads() {
+    return {{"ac-journal", flusher_.native_handle()}};
+}
+
+order_journal::~order_journal() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (flusher_.joinable()) {
+        flusher_.join();
+    }
+    try {
+        syncPending_();
+    } catch (const std::exception& e) {
+        AC_LOG_ERROR("Journal final sync failed: {}", e.what());
+    }
+}
+
+void order_journal::openSegment_(uint64_t number, size_t minimumBytes) {
+    auto segment = std::make_shared<Segment>();
+    segment->number = number;
+    size_t capacity = std::max(config_.segmentBytes, sizeof(JournalFileHeader) + minimumBytes);
+    segment->capacity = (capacity + pageSize() - 1) / pageSize() * pageSize();
+
+    std::string path = config_.directory + "/" + fileName(kSegmentPrefix, number);
+    segment->fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (segment->fd < 0) {
+        throw std::runtime_error("Cannot create journal segment: " + path + ": " + std::strerror(errno));
+    }
+    // Real blocks up front: a full disk fails here instead of as SIGBUS on a store
+    int error = ::posix_fallocate(segment->fd, 0, static_cast<off_t>(segment->capacity));
+    if (error == EINVAL || error == EOPNOTSUPP) {
+        error = ::ftruncate(segment->fd, static_cast<off_t>(segment->capacity)) == 0 ? 0 : errno;
+    }
+    if (error != 0) {
+        throw std::runtime_error("Cannot size journal segment: " + path + ": " + std::strerror(error));
+    }
+    void* base = ::mmap(nullptr, segment->capacity, PROT_READ | PROT_WRITE, MAP_SHARED, segment->fd, 0);
+    if (base == MAP_FAILED) {
+        throw std::runtime_error("mmap failed for journal segment: " + path);
+    }
+    segment->base = static_cast<char*>(base);
+
+    JournalFileHeader header{};
+    std::memcpy(header.magic, kSegmentMagic, sizeof(kSegmentMagic));
+    header.version = kJournalVersion;
+    header.segment = number;
+    std::memcpy(segment->base, &header, sizeof(header));
+    segment->used = sizeof(header);
+    appended_ += sizeof(header);
+    syncDirectory(config_.directory);
+
+    if (current_) {
+        retired_.push_back(std::move(current_));
+    }
+    current_ = std::move(segment);
+    ++stats_.segments;
+}
+
+void order_journal::append(const batch& records) {
+    if (records.empty()) {
+        return;
+    }
+    const size_t bytes = records.bytes_.size();
+    std::lock_guard lock(mutex_);
+    if (current_->used + bytes > current_->capacity) {
+        openSegment_(nextSegment_++, bytes);
+    }
+    std::memcpy(current_->base + current_->used, records.bytes_.data(), bytes);
+    current_->used += bytes;
+    appended_ += bytes;
+    stats_.records += records.records_;
+    stats_.bytes += bytes;
+}
+
+void order_journal::commit() {
+    std::unique_lock lock(mutex_);
+    uint64_t target = appended_;
+    if (durable_ >= target) {
+        return;
+    }
+    commitRequested_ = true;
+    wake_.notify_one();
+    durableChanged_.wait(lock, [&] { return durable_ >= target || stopping_; });
+}
+
+void order_journal::syncPending_() {
+    std::lock_guard flush(flushMutex_);
+    std::vector<std::shared_ptr<Segment>> retired;
+    std::shared_ptr<Segment> current;
+    size_t used = 0;
+    uint64_t target = 0;
+    {
+        std::lock_guard lock(mutex_);
+        retired.swap(retired_);
+        current = current_;
+        used = current ? current->used : 0;
+        target = appended_;
+    }
+    if (target == durable_) {
+        return;
+    }
+
+    auto sync = [](Segment& segment, size_t end) {
+        size_t begin = segment.synced / pageSize() * pageSize();
+        if (end > begin && ::msync(segment.base + begin, end - begin, MS_SYNC) != 0) {
+            throw std::runtime_error("Journal msync failed: " + std::string(std::strerror(errno)));
+        }
+        segment.synced = end;
+    };
+    for (auto& segment : retired) {
+        sync(*segment, segment->used); // no appends reach a retired segment
+    }
+    if (current) {
+        sync(*current, used);
+    }
+
+    {
+        std::lock_guard lock(mutex_);
+        durable_ = std::max(durable_, target);
+        ++stats_.commits;
+    }
+    durableChanged_.notify_all();
+}
+
+void order_journal::flusherLoop_() {
+    auto lastSnapshot = std::chrono::steady_clock::now();
+    std::unique_lock lock(mutex_);
+    while (!stopping_) {
+        wake_.wait_for(lock, config_.commitInterval, [&] { return stopping_ || commitRequested_; });
+        commitRequested_ = false;
+        if (stopping_) {
+            break;
+        }
+        lock.unlock();
+        try {
+            syncPending_();
+        } catch (const std::exception& e) {
+            AC_LOG_ERROR("{}", e.what());
+        }
+
+        if (config_.snapshotInterval.count() > 0 &&
+            std::chrono::steady_clock::now() - lastSnapshot >= config_.snapshotInterval) {
+            std::function<void()> callback;
+            {
+                std::lock_guard guard(mutex_);
+                callback = snapshotCallback_;
+            }
+            if (callback) {
+                try {
+                    callback();
+                } catch (const std::exception& e) {
+                    AC_LOG_ERROR("Journal snapshot failed: {}", e.what());
+                }
+            }
+            lastSnapshot = std::chrono::steady_clock::now();
+        }
+        lock.lock();
+    }
+    durableChanged_.notify_all(); // committers blocked on a stopping journal
+}
+
+uint64_t order_journal::beginSnapshot() {
+    std::lock_guard lock(mutex_);
+    uint64_t number = nextSegment_++;
+    openSegment_(number, 0);
+    return number;
+}
+
+void order_journal::writeSnapshot(uint64_t segment, const batch& state) {
+    std::string path = config_.directory + "/" + fileName(kSnapshotPrefix, segment);
+    std::string temporary = path + ".tmp";
+
+    JournalFileHeader header{};
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+    header.version = kJournalVersion;
+    header.segment = segment;
+    header.records = state.records_;
+    header.bytes = state.bytes_.size();
+
+    int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot create snapshot: " + temporary);
+    }
+    auto writeAll = [&](const char* data, size_t bytes) {
+        while (bytes > 0) {
+            ssize_t written = ::write(fd, data, bytes);
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written <= 0) {
+                ::close(fd);
+                ::unlink(temporary.c_str());
+                throw std::runtime_error("Snapshot write failed: " + std::string(std::strerror(errno)));
+            }
+            data += written;
+            bytes -= static_cast<size_t>(written);
+        }
+    };
+    writeAll(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeAll(state.bytes_.data(), state.bytes_.size());
+    if (::fsync(fd) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Snapshot fsync failed: " + temporary);
+    }
+    ::close(fd);
+    if (::rename(temporary.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Cannot publish snapshot: " + path);
+    }
+    syncDirectory(config_.directory);
+
+    // Everything before `segment` is now covered by the snapshot
+    for (uint64_t number : listFiles(config_.directory, kSegmentPrefix)) {
+        if (number < segment) {
+            ::unlink((config_.directory + "/" + fileName(kSegmentPrefix, number)).c_str());
+        }
+    }
+    for (uint64_t number : listFiles(config_.directory, kSnapshotPrefix)) {
+        if (number < segment) {
+            ::unlink((config_.directory + "/" + fileName(kSnapshotPrefix, number)).c_str());
+        }
+    }
+
+    std::lock_guard lock(mutex_);
+    ++stats_.snapshots;
+}
+
+void order_journal::setSnapshotCallback(std::function<void()> callback) {
+    std::lock_guard lock(mutex_);
+    snapshotCallback_ = std::move(callback);
+}
+
+JournalStats order_journal::stats() const {
+    std::lock_guard lock(mutex_);
+    return stats_;
+}
+
+JournalReplayStats order_journal::replay(const std::string& directory,
+                                         const std::function<void(const JournalRecord&)>& fn) {
+    JournalReplayStats stats;
+    auto snapshots = listFiles(directory, kSnapshotPrefix);
+    if (!snapshots.empty()) {
+        uint64_t number = snapshots.back();
+        std::string path = directory + "/" + fileName(kSnapshotPrefix, number);
+        mapped_file file(path);
+        const JournalFileHeader& header = file.header();
+        if (std::memcmp(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0 ||
+            header.bytes != file.size() - sizeof(JournalFileHeader)) {
+            throw std::runtime_error("Not a valid snapshot: " + path);
+        }
+        checkVersion(header, path);
+        // Snapshots are published whole by rename, so a bad record is corruption
+        bool intact = forEachRecord(file.data() + sizeof(JournalFileHeader), file.data() + file.size(),
+                                    stats.snapshotRecords, stats.bytes, fn);
+        if (!intact || stats.snapshotRecords != header.records) {
+            throw std::runtime_error("Corrupt snapshot: " + path);
+        }
+        stats.snapshotSegment = number;
+    }
+
+    for (uint64_t number : listFiles(directory, kSegmentPrefix)) {
+        if (number < stats.snapshotSegment) {
+            continue; // superseded; a crash interrupted the cleanup
+        }
+        std::string path = directory + "/" + fileName(kSegmentPrefix, number);
+        mapped_file file(path);
+        if (std::memcmp(file.header().magic, kSegmentMagic, sizeof(kSegmentMagic)) != 0) {
+            throw std::runtime_error("Not a valid journal segment: " + path);
+        }
+        checkVersion(file.header(), path);
+        ++stats.segments;
+        if (!forEachRecord(file.data() + sizeof(JournalFileHeader), file.data() + file.size(),
+                           stats.segmentRecords, stats.bytes, fn)) {
+            ++stats.tornSegments;
+            AC_LOG_WARN("Journal segment {} ends in a torn record; replay continues with the next", path);
+        }
+    }
+    return stats;
+}
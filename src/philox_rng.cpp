@@ -0,0 +1,188 @@
+#include "philox_rng.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <utility>
+
+namespace {
+
+constexpr uint32_t kMultiplier0 = 0xD2511F53u;
+constexpr uint32_t kMultiplier1 = 0xCD9E8D57u;
+constexpr uint32_t kWeyl0 = 0x9E3779B9u;
+constexpr uint32_t kWeyl1 = 0xBB67AE85u;
+constexpr int kRounds = 10;
+
+// Blocks per pass of fillNormal: the words of a pass live in small arrays and
+// each step runs over all of them at once, so the lane loops vectorize. They
+// are kept rolled (#pragma GCC unroll 1); -O3 would otherwise unroll them
+// completely first, and only part of the result vectorizes.
+constexpr size_t kLanes = 8;
+
+inline void round(uint32_t& c0, uint32_t& c1, uint32_t& c2, uint32_t& c3, uint32_t k0, uint32_t k1) {
+    const uint64_t p0 = uint64_t{kMultiplier0} * c0;
+    const uint64_t p1 = uint64_t{kMultiplier1} * c2;
+    c0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+    c2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+    c1 = static_cast<uint32_t>(p1);
+    c3 = static_cast<uint32_t>(p0);
+}
+
+// Box-Muller needs a log and a sine/cosine per pair, and libm calls keep a
+// loop scalar. The helpers below are straight-line bit operations and
+// polynomials instead (within a few ulp on the ranges used), so the lane loop
+// vectorizes and the draws do not depend on the libm the binary runs against.
+
+constexpr uint64_t kMantissa = 0x000FFFFFFFFFFFFFull;
+constexpr uint64_t kOne = 0x3FF0000000000000ull;
+
+// Top 52 bits as a double in [1, 2); the integer conversions have no SSE2
+// vector form, the bit pattern does
+inline double unitInterval(uint32_t lo, uint32_t hi) {
+    const uint64_t bits = uint64_t{lo} | (uint64_t{hi} << 32);
+    return std::bit_cast<double>((bits >> 12) | kOne);
+}
+
+// (-1)^n / (first + 2n)!
+template <size_t N>
+constexpr std::array<double, N> taylor(int first) {
+    std::array<double, N> result{};
+    double factorial = 1.0;
+    for (int i = 2; i <= first; ++i) {
+        factorial *= i;
+    }
+    for (size_t n = 0; n < N; ++n) {
+        result[n] = (n % 2 == 0 ? 1.0 : -1.0) / factorial;
+        const int next = first + 2 * static_cast<int>(n);
+        factorial *= static_cast<double>(next + 1) * static_cast<double>(next + 2);
+    }
+    return result;
+}
+
+// sum c[n] x^n, unrolled at compile time: a loop here would be an inner loop
+// of the lane loop, which stops it vectorizing
+template <size_t N, size_t... I>
+inline double hornerImpl(const std::array<double, N>& c, double x, std::index_sequence<I...>) {
+    double result = 0.0;
+    ((result = result * x + c[N - 1 - I]), ...);
+    return result;
+}
+
+template <size_t N>
+inline double horner(const std::array<double, N>& c, double x) {
+    return hornerImpl(c, x, std::make_index_sequence<N>{});
+}
+
+// 1 / (2n + 1)
+template <size_t N>
+constexpr std::array<double, N> oddReciprocals() {
+    std::array<double, N> result{};
+    for (size_t n = 0; n < N; ++n) {
+        result[n] = 1.0 / static_cast<double>(2 * n + 1);
+    }
+    return result;
+}
+
+// log(u) for u in (0, 1]: u = 2^e m with m in [sqrt(1/2), sqrt(2)), and
+// log(m) = 2 atanh(f), f = (m - 1) / (m + 1) <= 0.172, as an odd series in f
+inline double logUnit(double u) {
+    const uint64_t bits = std::bit_cast<uint64_t>(u);
+    double m = std::bit_cast<double>((bits & kMantissa) | kOne);
+    double e = std::bit_cast<double>((bits >> 52) | 0x4330000000000000ull) - (0x1.0p52 + 1023.0);
+    const bool high = m >= std::numbers::sqrt2;
+    m = high ? 0.5 * m : m;
+    e = high ? e + 1.0 : e;
+
+    static constexpr auto kAtanh = oddReciprocals<10>();
+    const double f = (m - 1.0) / (m + 1.0);
+    return e * std::numbers::ln2 + 2.0 * f * horner(kAtanh, f * f);
+}
+
+// cos and sin of 2 pi v for v in [0, 1): round 4v to a quarter turn k, take
+// Taylor polynomials of the rest (within pi/4), then swap and flip signs by k
+inline void sinCosTurn(double v, double& cosine, double& sine) {
+    static constexpr auto kSin = taylor<8>(1);
+    static constexpr auto kCos = taylor<9>(0);
+    constexpr double kRound = 0x1.8p52; // adding it leaves round(x) in the low bits
+    const double shifted = 4.0 * v + kRound;
+    const uint64_t k = std::bit_cast<uint64_t>(shifted);
+    const double x = (4.0 * v - (shifted - kRound)) * (std::numbers::pi / 2.0);
+    const double x2 = x * x;
+
+    const double s = x * horner(kSin, x2);
+    const double c = horner(kCos, x2);
+
+    const uint64_t swap = 0 - (k & 1);  // all ones in odd quarters
+    const uint64_t sBits = std::bit_cast<uint64_t>(s);
+    const uint64_t cBits = std::bit_cast<uint64_t>(c);
+    sine = std::bit_cast<double>(((cBits & swap) | (sBits & ~swap)) ^ ((k & 2) << 62));
+    cosine = std::bit_cast<double>(((sBits & swap) | (cBits & ~swap)) ^ (((k + 1) & 2) << 62));
+}
+
+} // namespace
+
+philox_rng::Block philox_rng::generate(uint64_t block) const {
+    uint32_t c0 = static_cast<uint32_t>(block);
+    uint32_t c1 = static_cast<uint32_t>(block >> 32);
+    uint32_t c2 = static_cast<uint32_t>(stream_);
+    uint32_t c3 = static_cast<uint32_t>(stream_ >> 32);
+    uint32_t k0 = static_cast<uint32_t>(key_);
+    uint32_t k1 = static_cast<uint32_t>(key_ >> 32);
+    for (int r = 0; r < kRounds; ++r) {
+        round(c0, c1, c2, c3, k0, k1);
+        k0 += kWeyl0;
+        k1 += kWeyl1;
+    }
+    return {c0, c1, c2, c3};
+}
+
+void philox_rng::fillNormal(std::span<double> out) {
+    alignas(64) uint32_t w0[kLanes];
+    alignas(64) uint32_t w1[kLanes];
+    alignas(64) uint32_t w2[kLanes];
+    alignas(64) uint32_t w3[kLanes];
+    alignas(64) double radius[kLanes];
+    alignas(64) double cosine[kLanes];
+    alignas(64) double sine[kLanes];
+
+    const uint32_t s0 = static_cast<uint32_t>(stream_);
+    const uint32_t s1 = static_cast<uint32_t>(stream_ >> 32);
+    half_ = 2; // a half-used block is not reused
+    for (size_t done = 0; done < out.size(); done += 2 * kLanes) {
+        // Always a full pass, so the lane loops have fixed trip counts; the
+        // tail's unused blocks are generated and thrown away
+        #pragma GCC unroll 1
+        for (size_t j = 0; j < kLanes; ++j) {
+            const uint64_t counter = block_ + j;
+            w0[j] = static_cast<uint32_t>(counter);
+            w1[j] = static_cast<uint32_t>(counter >> 32);
+            w2[j] = s0;
+            w3[j] = s1;
+        }
+        uint32_t k0 = static_cast<uint32_t>(key_);
+        uint32_t k1 = static_cast<uint32_t>(key_ >> 32);
+        for (int r = 0; r < kRounds; ++r) {
+            #pragma GCC unroll 1
+            for (size_t j = 0; j < kLanes; ++j) {
+                round(w0[j], w1[j], w2[j], w3[j], k0, k1);
+            }
+            k0 += kWeyl0;
+            k1 += kWeyl1;
+        }
+
+        #pragma GCC unroll 1
+        for (size_t j = 0; j < kLanes; ++j) {
+            // 2 - [1, 2) is (0, 1], so the log is finite
+            radius[j] = std::sqrt(-2.0 * logUnit(2.0 - unitInterval(w0[j], w1[j])));
+            sinCosTurn(unitInterval(w2[j], w3[j]) - 1.0, cosine[j], sine[j]);
+        }
+
+        const size_t count = std::min(2 * kLanes, out.size() - done);
+        for (size_t i = 0; i < count; ++i) {
+            out[done + i] = radius[i / 2] * (i % 2 == 0 ? cosine[i / 2] : sine[i / 2]);
+        }
+        block_ += (count + 1) / 2;
+    }
+}
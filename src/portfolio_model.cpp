@@ -0,0 +1,233 @@
+#include "portfolio_model.hpp"
+#include "async_logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+constexpr size_t kSlice = 64;
+
+void requireSymmetric(const dense_matrix& m, const char* name) {
+    for (size_t i = 0; i < m.rows(); ++i) {
+        for (size_t j = 0; j < i; ++j) {
+            double scale = std::max({std::abs(m(i, j)), std::abs(m(j, i)), 1e-300});
+            if (std::abs(m(i, j) - m(j, i)) > 1e-9 * scale) {
+                throw std::invalid_argument(std::string(name) + " must be symmetric");
+            }
+        }
+    }
+}
+
+bool isDiagonal(const dense_matrix& m) {
+    for (size_t i = 0; i < m.rows(); ++i) {
+        for (size_t j = 0; j < m.cols(); ++j) {
+            if (i != j && m(i, j) != 0.0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+} // namespace
+
+PortfolioLiquidationModel::PortfolioLiquidationModel(unsigned threads)
+    : threads_(threads) {}
+
+void PortfolioLiquidationModel::setParameters(const std::vector<double>& covariance,
+                                              const std::vector<double>& impact, double lambda,
+                                              const std::vector<double>& positions, double timeHorizon) {
+    const size_t n = positions.size();
+    if (n == 0) {
+        throw std::invalid_argument("Basket must hold at least one asset");
+    }
+    if (!(lambda >= 0.0) || !(timeHorizon > 0.0)) {
+        throw std::invalid_argument("lambda must be non-negative and timeHorizon positive");
+    }
+    dense_matrix c = dense_matrix::fromRowMajor(n, n, covariance);
+    dense_matrix h = dense_matrix::fromRowMajor(n, n, impact);
+    requireSymmetric(c, "covariance");
+    requireSymmetric(h, "impact");
+
+    auto started = std::chrono::steady_clock::now();
+    parallel_team team(threads_);
+
+    // A = λ L^{-1} C L^{-T}
+    dense_matrix a;
+    if (isDiagonal(h)) {
+        lower_ = dense_matrix(n, n);
+        for (size_t i = 0; i < n; ++i) {
+            if (!(h(i, i) > 0.0)) {
+                throw std::invalid_argument("impact must be positive definite");
+            }
+            lower_(i, i) = std::sqrt(h(i, i));
+        }
+        a = dense_matrix(n, n);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                a(i, j) = lambda * c(i, j) / (lower_(i, i) * lower_(j, j));
+            }
+        }
+    } else {
+        try {
+            linalg::choleskyInPlace(h, team);
+        } catch (const std::invalid_argument&) {
+            throw std::invalid_argument("impact must be positive definite");
+        }
+        lower_ = std::move(h);
+        linalg::solveLowerInPlace(lower_, c, team);  // L^{-1} C
+        a = c.transposed();                          // C L^{-T}, as C is symmetric
+        linalg::solveLowerInPlace(lower_, a, team);  // L^{-1} C L^{-T}
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < i; ++j) {
+                double mean = 0.5 * lambda * (a(i, j) + a(j, i));
+                a(i, j) = mean;
+                a(j, i) = mean;
+            }
+            a(i, i) *= lambda;
+        }
+    }
+
+    std::vector<double> eigenvalues;
+    linalg::symmetricEigen(a, eigenvalues, eigenvectorRows_, team);
+
+    assets_ = n;
+    lambda_ = lambda;
+    timeHorizon_ = timeHorizon;
+    kappas_.resize(n);
+    modes_.resize(n);
+    for (size_t j = 0; j < n; ++j) {
+        kappas_[j] = std::sqrt(std::max(0.0, eigenvalues[j]));
+        modes_[j] = trajectory::Params::make(kappas_[j], timeHorizon, 1.0);
+    }
+
+    // Asset holdings carried by one unit of each mode: L^{-T} u_j
+    modeHoldings_ = eigenvectorRows_;
+    team.parallelFor(n, 16, [&](size_t begin, size_t end) {
+        for (size_t j = begin; j < end; ++j) {
+            linalg::solveLowerTransposedInPlace(lower_, modeHoldings_.row(j));
+        }
+    });
+
+    setPositions(positions);
+
+    AC_LOG_INFO("Portfolio model: {} assets, kappa {} .. {}, {} us", n,
+                *std::min_element(kappas_.begin(), kappas_.end()),
+                *std::max_element(kappas_.begin(), kappas_.end()),
+                std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started).count());
+}
+
+void PortfolioLiquidationModel::setPositions(const std::vector<double>& positions) {
+    modeWeights_ = modeWeightsFor_(positions);
+}
+
+std::vector<double> PortfolioLiquidationModel::modeWeightsFor_(const std::vector<double>& positions) const {
+    if (positions.size() != assets_) {
+        throw std::invalid_argument("positions must have one entry per asset");
+    }
+    // y0 = L^T x0, gathered row by row of L; then mode weights U^T y0
+    std::vector<double> y(assets_, 0.0);
+    for (size_t p = 0; p < assets_; ++p) {
+        const double* lp = lower_.row(p);
+        const double xp = positions[p];
+        for (size_t i = 0; i <= p; ++i) {
+            y[i] += lp[i] * xp;
+        }
+    }
+    std::vector<double> weights(assets_, 0.0);
+    for (size_t j = 0; j < assets_; ++j) {
+        const double* u = eigenvectorRows_.row(j);
+        double sum = 0.0;
+        for (size_t i = 0; i < assets_; ++i) {
+            sum += u[i] * y[i];
+        }
+        weights[j] = sum;
+    }
+    return weights;
+}
+
+double PortfolioLiquidationModel::modeFraction_(size_t mode, double t) const {
+    const trajectory::Params& params = modes_[mode];
+    return params.shape == trajectory::Shape::Linear
+        ? trajectory::remainingAt<trajectory::Shape::Linear>(params, t)
+        : trajectory::remainingAt<trajectory::Shape::Hyperbolic>(params, t);
+}
+
+std::vector<double> PortfolioLiquidationModel::holdingsAt(double t) const {
+    std::vector<double> holdings(assets_, 0.0);
+    for (size_t j = 0; j < assets_; ++j) {
+        const double g = modeWeights_[j] * modeFraction_(j, t);
+        const double* row = modeHoldings_.row(j);
+        for (size_t i = 0; i < assets_; ++i) {
+            holdings[i] += g * row[i];
+        }
+    }
+    return holdings;
+}
+
+std::vector<double> PortfolioLiquidationModel::calculateOptimalSchedule(int intervals) const {
+    return schedule_(modeWeights_, intervals);
+}
+
+std::vector<double> PortfolioLiquidationModel::calculateOptimalSchedule(const std::vector<double>& positions,
+                                                                       int intervals) const {
+    return schedule_(modeWeightsFor_(positions), intervals);
+}
+
+std::vector<double> PortfolioLiquidationModel::schedule_(const std::vector<double>& modeWeights, int intervals) const {
+    if (intervals <= 0) {
+        throw std::invalid_argument("calculateOptimalSchedule needs a positive interval count");
+    }
+    if (assets_ == 0) {
+        throw std::logic_error("setParameters has not been called");
+    }
+    const size_t n = assets_;
+    const size_t boundaries = static_cast<size_t>(intervals) + 1;
+
+    // weights[m][j]: how much of mode j is left at boundary m
+    std::vector<double> weights(boundaries * n);
+    for (size_t m = 0; m < boundaries; ++m) {
+        double t = timeHorizon_ * static_cast<double>(m) / intervals;
+        for (size_t j = 0; j < n; ++j) {
+            weights[m * n + j] = modeWeights[j] * modeFraction_(j, t);
+        }
+    }
+
+    // holdings[m] = sum_j weights[m][j] * modeHoldings_[j], one column slice
+    // per task so that slice of every boundary stays in cache while the mode
+    // rows stream past once
+    std::vector<double> holdings(boundaries * n, 0.0);
+    const size_t slices = (n + kSlice - 1) / kSlice;
+    auto accumulate = [&](size_t begin, size_t end) {
+        for (size_t slice = begin; slice < end; ++slice) {
+            const size_t c0 = slice * kSlice;
+            const size_t width = std::min(n, c0 + kSlice) - c0;
+            for (size_t j = 0; j < n; ++j) {
+                const double* row = modeHoldings_.row(j) + c0;
+                for (size_t m = 0; m < boundaries; ++m) {
+                    const double g = weights[m * n + j];
+                    double* out = holdings.data() + m * n + c0;
+                    for (size_t c = 0; c < width; ++c) {
+                        out[c] += g * row[c];
+                    }
+                }
+            }
+        }
+    };
+    if (n * n * boundaries < (size_t{1} << 20)) {
+        accumulate(0, slices);
+    } else {
+        parallel_team team(threads_);
+        team.parallelFor(slices, 1, accumulate);
+    }
+
+    std::vector<double> schedule(static_cast<size_t>(intervals) * n);
+    for (size_t k = 0; k < static_cast<size_t>(intervals); ++k) {
+        for (size_t i = 0; i < n; ++i) {
+            // The last boundary is exactly zero holdings
+            double next = k + 1 == static_cast<size_t>(intervals) ? 0.0 : holdings[(k + 1) * n + i];
+            schedule[k * n + i] = holdings[k * n + i] - next;
+        }
+    }
+    return schedule;
+}
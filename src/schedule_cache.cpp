@@ -0,0 +1,84 @@
+#include "schedule_cache.hpp"
+#include <bit>
+
+bool ScheduleKey::operator==(const ScheduleKey& other) const {
+    return std::bit_cast<uint64_t>(kappa) == std::bit_cast<uint64_t>(other.kappa) &&
+           std::bit_cast<uint64_t>(timeHorizon) == std::bit_cast<uint64_t>(other.timeHorizon) &&
+           intervals == other.intervals;
+}
+
+size_t schedule_cache::KeyHash::operator()(const ScheduleKey& key) const {
+    uint64_t h = std::bit_cast<uint64_t>(key.kappa) * 0x9E3779B97F4A7C15ull;
+    h ^= std::bit_cast<uint64_t>(key.timeHorizon) + 0xBF58476D1CE4E5B9ull + (h << 6) + (h >> 2);
+    h ^= static_cast<uint64_t>(key.intervals) + 0x94D049BB133111EBull + (h << 6) + (h >> 2);
+    return static_cast<size_t>(h ^ (h >> 32));
+}
+
+schedule_cache::schedule_cache(size_t capacity)
+    : capacity_(capacity),
+      shardCapacity_(capacity == 0 ? 0 : (capacity + kShards - 1) / kShards) {}
+
+schedule_cache::Shape schedule_cache::shape(const ScheduleKey& key, const Compute& compute) {
+    if (shardCapacity_ == 0) {
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return std::make_shared<const std::vector<double>>(compute());
+    }
+
+    Shard& shard = shardFor_(key);
+    {
+        std::lock_guard lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return it->second->second;
+        }
+    }
+    misses_.fetch_add(1, std::memory_order_relaxed);
+
+    Shape computed = std::make_shared<const std::vector<double>>(compute());
+
+    std::lock_guard lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        return it->second->second; // another thread got there first
+    }
+    shard.entries.emplace_front(key, computed);
+    shard.index.emplace(key, shard.entries.begin());
+    if (shard.entries.size() > shardCapacity_) {
+        shard.index.erase(shard.entries.back().first);
+        shard.entries.pop_back();
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return computed;
+}
+
+std::vector<double> schedule_cache::schedule(const ScheduleKey& key, double totalShares, const Compute& compute) {
+    Shape fractions = shape(key, compute);
+    std::vector<double> result(fractions->size());
+    for (size_t i = 0; i < result.size(); ++i) {
+        result[i] = (*fractions)[i] * totalShares;
+    }
+    return result;
+}
+
+ScheduleCacheStats schedule_cache::stats() const {
+    ScheduleCacheStats stats;
+    stats.hits = hits_.load(std::memory_order_relaxed);
+    stats.misses = misses_.load(std::memory_order_relaxed);
+    stats.evictions = evictions_.load(std::memory_order_relaxed);
+    stats.capacity = capacity_;
+    for (const Shard& shard : shards_) {
+        std::lock_guard lock(shard.mutex);
+        stats.size += shard.entries.size();
+    }
+    return stats;
+}
+
+void schedule_cache::clear() {
+    for (Shard& shard : shards_) {
+        std::lock_guard lock(shard.mutex);
+        shard.index.clear();
+        shard.entries.clear();
+    }
+}
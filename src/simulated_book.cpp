@@ -0,0 +1,107 @@
+#include "simulated_book.hpp"
+#include <algorithm>
+#include <cmath>
+
+simulated_book::simulated_book(const quote_board& quotes, const BookConfig& config)
+    : quotes_(quotes),
+      depth_(std::min(config.depth, kMaxDepth)),
+      tickSize_(config.tickSize),
+      recoveryNs_(std::chrono::duration_cast<std::chrono::nanoseconds>(config.recovery).count()),
+      books_(new Book[quotes.capacity()]) {
+    for (size_t k = 0; k < kMaxDepth; ++k) {
+        growth_[k] = std::pow(config.depthGrowth, static_cast<double>(k));
+    }
+}
+
+std::optional<BookFill> simulated_book::take(SymbolId symbol, bool isBuy, double shares, int64_t nowNs) {
+    if (depth_ == 0 || symbol >= quotes_.capacity()) {
+        return std::nullopt;
+    }
+    Book& book = books_[symbol];
+    sync_(symbol, book, nowNs);
+    const double best = isBuy ? book.bestAsk : book.bestBid;
+    const double top = isBuy ? book.topAskSize : book.topBidSize;
+    if (!book.valid || !(best > 0.0) || !(top > 0.0)) {
+        return std::nullopt;
+    }
+    replenish_(book, nowNs);
+
+    std::array<double, kMaxDepth>& left = isBuy ? book.askLeft : book.bidLeft;
+    const double tick = isBuy ? tickSize_ : -tickSize_;
+    BookFill fill;
+    double wanted = shares;
+    for (size_t k = 0; k < depth_ && wanted > 0.0; ++k) {
+        const double price = best + tick * static_cast<double>(k);
+        if (price <= 0.0) {
+            break;
+        }
+        const double size = std::min(left[k], wanted);
+        if (size <= 0.0) {
+            continue;
+        }
+        left[k] -= size;
+        wanted -= size;
+        fill.shares += size;
+        fill.notional += size * price;
+        fill.lastPrice = price;
+        ++fill.levels;
+    }
+
+    book.takes.store(book.takes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    book.levels.store(book.levels.load(std::memory_order_relaxed) + fill.levels, std::memory_order_relaxed);
+    if (fill.shares < shares) {
+        book.partialTakes.store(book.partialTakes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    return fill;
+}
+
+void simulated_book::sync_(SymbolId symbol, Book& book, int64_t nowNs) {
+    uint32_t version = quotes_.version(symbol);
+    if (version == book.version) {
+        return;
+    }
+    MarketQuote quote;
+    if (!quotes_.read(symbol, quote)) {
+        return;
+    }
+    book.version = version;
+    book.valid = !(quote.bidPrice > 0.0 && quote.askPrice > 0.0 && quote.askPrice < quote.bidPrice);
+    book.bestBid = quote.bidPrice;
+    book.bestAsk = quote.askPrice;
+    book.topBidSize = std::max(0, quote.bidSize);
+    book.topAskSize = std::max(0, quote.askSize);
+    for (size_t k = 0; k < depth_; ++k) {
+        book.bidLeft[k] = book.topBidSize * growth_[k];
+        book.askLeft[k] = book.topAskSize * growth_[k];
+    }
+    book.updatedNs = nowNs;
+    book.rebuilds.store(book.rebuilds.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void simulated_book::replenish_(Book& book, int64_t nowNs) const {
+    const int64_t elapsed = nowNs - book.updatedNs;
+    if (elapsed <= 0) {
+        return;
+    }
+    book.updatedNs = nowNs;
+    const double fraction = recoveryNs_ <= 0 ? 1.0
+                                             : std::min(1.0, static_cast<double>(elapsed) / static_cast<double>(recoveryNs_));
+    for (size_t k = 0; k < depth_; ++k) {
+        const double bid = book.topBidSize * growth_[k];
+        const double ask = book.topAskSize * growth_[k];
+        book.bidLeft[k] = std::min(bid, book.bidLeft[k] + bid * fraction);
+        book.askLeft[k] = std::min(ask, book.askLeft[k] + ask * fraction);
+    }
+}
+
+BookStats simulated_book::stats() const {
+    BookStats total;
+    for (size_t i = 0; i < quotes_.capacity(); ++i) {
+        const Book& book = books_[i];
+        total.rebuilds += book.rebuilds.load(std::memory_order_relaxed);
+        total.takes += book.takes.load(std::memory_order_relaxed);
+        total.partialTakes += book.partialTakes.load(std::memory_order_relaxed);
+        total.levels += book.levels.load(std::memory_order_relaxed);
+    }
+    return total;
+}
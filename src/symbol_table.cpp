@@ -0,0 +1,80 @@
+#include "symbol_table.hpp"
+#include <bit>
+#include <stdexcept>
+
+symbol_table::symbol_table(size_t capacity)
+    : capacity_(capacity),
+      mask_(std::bit_ceil(capacity * 2) - 1), // load factor <= 0.5 keeps probes short
+      slots_(new std::atomic<uint32_t>[mask_ + 1]),
+      names_(new std::atomic<const std::string*>[capacity]) {
+    for (size_t i = 0; i <= mask_; ++i) {
+        slots_[i].store(0, std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < capacity_; ++i) {
+        names_[i].store(nullptr, std::memory_order_relaxed);
+    }
+    storage_.reserve(capacity_);
+}
+
+uint64_t symbol_table::hash_(std::string_view symbol) {
+    // FNV-1a
+    uint64_t hash = 1469598103934665603ull;
+    for (unsigned char c : symbol) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+SymbolId symbol_table::probe_(std::string_view symbol, uint64_t hash, size_t& emptySlot) const {
+    for (size_t i = hash & mask_;; i = (i + 1) & mask_) {
+        uint32_t entry = slots_[i].load(std::memory_order_acquire);
+        if (entry == 0) {
+            emptySlot = i;
+            return kInvalidSymbol;
+        }
+        SymbolId id = entry - 1;
+        const std::string* name = names_[id].load(std::memory_order_acquire);
+        if (*name == symbol) {
+            return id;
+        }
+    }
+}
+
+SymbolId symbol_table::find(std::string_view symbol) const {
+    size_t emptySlot;
+    return probe_(symbol, hash_(symbol), emptySlot);
+}
+
+SymbolId symbol_table::intern(std::string_view symbol) {
+    uint64_t hash = hash_(symbol);
+    size_t emptySlot;
+    SymbolId id = probe_(symbol, hash, emptySlot);
+    if (id != kInvalidSymbol) {
+        return id;
+    }
+
+    std::lock_guard lock(mutex_);
+    // Another writer may have added it (or taken our empty slot) meanwhile
+    id = probe_(symbol, hash, emptySlot);
+    if (id != kInvalidSymbol) {
+        return id;
+    }
+    uint32_t next = size_.load(std::memory_order_relaxed);
+    if (next >= capacity_) {
+        throw std::length_error("Symbol table full");
+    }
+
+    storage_.push_back(std::make_unique<std::string>(symbol));
+    names_[next].store(storage_.back().get(), std::memory_order_release);
+    slots_[emptySlot].store(next + 1, std::memory_order_release);
+    size_.store(next + 1, std::memory_order_release);
+    return next;
+}
+
+const std::string& symbol_table::name(SymbolId id) const {
+    if (id >= size()) {
+        throw std::out_of_range("Unknown symbol id");
+    }
+    return *names_[id].load(std::memory_order_acquire);
+}
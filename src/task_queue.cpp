@@ -0,0 +1,28 @@
+#include "task_queue.hpp"
+#include <algorithm>
+
+void binary_heap_queue::push(ScheduledTask task){
+    heap_.push_back(std::move(task));
+    std::push_heap(heap_.begin(), heap_.end());
+}
+
+void binary_heap_queue::popDue(TimePoint now, std::vector<ScheduledTask>& out){
+    while(!heap_.empty() && heap_.front().executionTime <= now){
+        std::pop_heap(heap_.begin(), heap_.end());
+        out.push_back(std::move(heap_.back())); // move, never copy the std::function
+        heap_.pop_back();
+    }
+}
+
+binary_heap_queue::TimePoint binary_heap_queue::nextDeadline() const {
+    return heap_.empty() ? TimePoint::max() : heap_.front().executionTime;
+}
+
+size_t binary_heap_queue::purgeStale(){
+    auto end = std::remove_if(heap_.begin(), heap_.end(),
+                              [](const ScheduledTask& task) { return !task.isLive(); });
+    size_t removed = static_cast<size_t>(heap_.end() - end);
+    heap_.erase(end, heap_.end());
+    std::make_heap(heap_.begin(), heap_.end());
+    return removed;
+}
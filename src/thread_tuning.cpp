@@ -0,0 +1,137 @@
+#include "thread_tuning.hpp"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+std::string failure(const char* what, int error) {
+    return std::string(what) + ": " + std::strerror(error);
+}
+} // namespace
+
+std::string ThreadReport::describe() const {
+    std::string text = name + ": name " + (named ? "set" : "not set");
+    if (!requested.cpus.empty()) {
+        text += ", cpus " + thread_tuning::formatCpuList(requested.cpus) + (pinned ? " applied" : " not applied");
+    }
+    if (requested.fifoPriority > 0) {
+        text += ", SCHED_FIFO " + std::to_string(requested.fifoPriority) + (realtime ? " applied" : " not applied");
+    }
+    if (!error.empty()) {
+        text += " (" + error + ")";
+    }
+    return text;
+}
+
+namespace thread_tuning {
+
+bool setName(std::thread::native_handle_type thread, const std::string& name) {
+#if defined(__linux__)
+    return pthread_setname_np(thread, name.substr(0, 15).c_str()) == 0;
+#else
+    (void)thread;
+    (void)name;
+    return false;
+#endif
+}
+
+ThreadReport apply(const NamedThread& thread, const ThreadPlacement& placement) {
+    ThreadReport report;
+    report.name = thread.name;
+    report.requested = placement;
+    report.named = setName(thread.handle, thread.name);
+#if defined(__linux__)
+    if (!placement.cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : placement.cpus) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &set);
+            }
+        }
+        int error = pthread_setaffinity_np(thread.handle, sizeof(set), &set);
+        report.pinned = error == 0;
+        if (error != 0) {
+            report.error = failure("affinity", error);
+        }
+    }
+    if (placement.fifoPriority > 0) {
+        sched_param param{};
+        param.sched_priority = placement.fifoPriority;
+        int error = pthread_setschedparam(thread.handle, SCHED_FIFO, &param);
+        report.realtime = error == 0;
+        if (error != 0 && report.error.empty()) {
+            report.error = failure("SCHED_FIFO", error);
+        }
+    }
+#else
+    if (!placement.cpus.empty() || placement.fifoPriority > 0) {
+        report.error = "thread placement is only supported on Linux";
+    }
+#endif
+    return report;
+}
+
+std::vector<int> parseCpuList(const std::string& text) {
+    std::vector<int> cpus;
+    size_t pos = 0;
+    auto number = [&]() {
+        size_t start = pos;
+        while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') {
+            ++pos;
+        }
+        if (start == pos || pos - start > 4) {
+            throw std::invalid_argument("Bad CPU list '" + text + "'");
+        }
+        return std::stoi(text.substr(start, pos - start));
+    };
+    while (pos < text.size()) {
+        int first = number();
+        int last = first;
+        if (pos < text.size() && text[pos] == '-') {
+            ++pos;
+            last = number();
+        }
+        if (last < first) {
+            throw std::invalid_argument("Bad CPU range in '" + text + "'");
+        }
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+        if (pos < text.size()) {
+            if (text[pos] != ',') {
+                throw std::invalid_argument("Bad CPU list '" + text + "'");
+            }
+            ++pos;
+        }
+    }
+    if (cpus.empty()) {
+        throw std::invalid_argument("Empty CPU list");
+    }
+    return cpus;
+}
+
+std::string formatCpuList(const std::vector<int>& cpus) {
+    std::string text;
+    for (size_t i = 0; i < cpus.size();) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+            ++j;
+        }
+        if (!text.empty()) {
+            text += ',';
+        }
+        text += std::to_string(cpus[i]);
+        if (j > i) {
+            text += '-' + std::to_string(cpus[j]);
+        }
+        i = j + 1;
+    }
+    return text;
+}
+
+} // namespace thread_tuning
@@ -0,0 +1,180 @@
+#include "tick_file.hpp"
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+constexpr char kMagic[8] = {'A', 'C', 'T', 'I', 'C', 'K', '\0', '\0'};
+
+void writeOrThrow(std::FILE* file, const void* data, size_t bytes) {
+    if (std::fwrite(data, 1, bytes, file) != bytes) {
+        throw std::runtime_error("Tick file write failed");
+    }
+}
+}
+
+TickFileWriter::TickFileWriter(const std::string& path) {
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        throw std::runtime_error("Cannot open tick file for writing: " + path);
+    }
+    std::setvbuf(file_, nullptr, _IOFBF, 1 << 20);
+
+    std::memcpy(header_.magic, kMagic, sizeof(kMagic));
+    header_.version = kTickFileVersion;
+    writeOrThrow(file_, &header_, sizeof(header_)); // placeholder, rewritten by finish()
+}
+
+TickFileWriter::~TickFileWriter() {
+    try {
+        finish();
+    } catch (...) {
+        // destructor must not throw; call finish() explicitly to see errors
+    }
+    if (file_) {
+        std::fclose(file_);
+    }
+}
+
+void TickFileWriter::write(const std::string& symbol, const MarketQuote& quote) {
+    auto [it, inserted] = symbolIndex_.try_emplace(symbol, static_cast<uint32_t>(symbols_.size()));
+    if (inserted) {
+        if (symbol.size() >= sizeof(TickSymbolName::name)) {
+            throw std::invalid_argument("Symbol too long for tick file: " + symbol);
+        }
+        symbols_.push_back(symbol);
+    }
+
+    TickRecord record{quote, it->second, 0};
+    writeOrThrow(file_, &record, sizeof(record));
+
+    uint64_t ts = static_cast<uint64_t>(quote.timestampNs);
+    if (header_.tickCount == 0) {
+        header_.firstTimestampNs = ts;
+    }
+    header_.lastTimestampNs = ts;
+    header_.tickCount++;
+}
+
+void TickFileWriter::finish() {
+    if (finished_) {
+        return;
+    }
+    finished_ = true;
+
+    header_.symbolCount = static_cast<uint32_t>(symbols_.size());
+    header_.symbolTableOffset = sizeof(TickFileHeader) + header_.tickCount * sizeof(TickRecord);
+    for (const auto& symbol : symbols_) {
+        TickSymbolName name{};
+        std::memcpy(name.name, symbol.data(), symbol.size());
+        writeOrThrow(file_, &name, sizeof(name));
+    }
+
+    if (std::fseek(file_, 0, SEEK_SET) != 0) {
+        throw std::runtime_error("Tick file seek failed");
+    }
+    writeOrThrow(file_, &header_, sizeof(header_));
+    if (std::fflush(file_) != 0) {
+        throw std::runtime_error("Tick file flush failed");
+    }
+}
+
+MappedTickFile::MappedTickFile(const std::string& path) {
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+        throw std::runtime_error("Cannot open tick file: " + path);
+    }
+    struct stat st{};
+    if (::fstat(fd_, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(TickFileHeader)) {
+        ::close(fd_);
+        throw std::runtime_error("Tick file too small: " + path);
+    }
+    length_ = static_cast<size_t>(st.st_size);
+
+    data_ = ::mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (data_ == MAP_FAILED) {
+        ::close(fd_);
+        throw std::runtime_error("mmap failed for tick file: " + path);
+    }
+    ::madvise(data_, length_, MADV_SEQUENTIAL); // aggressive readahead, early reclaim
+
+    const auto* bytes = static_cast<const char*>(data_);
+    header_ = reinterpret_cast<const TickFileHeader*>(bytes);
+    uint64_t expected = header_->symbolTableOffset + uint64_t{header_->symbolCount} * sizeof(TickSymbolName);
+    if (std::memcmp(header_->magic, kMagic, sizeof(kMagic)) != 0 ||
+        header_->version != kTickFileVersion ||
+        header_->tickCount > length_ / sizeof(TickRecord) ||  // keeps the product below from wrapping
+        header_->symbolTableOffset != sizeof(TickFileHeader) + header_->tickCount * sizeof(TickRecord) ||
+        expected > length_) {
+        ::munmap(data_, length_);
+        ::close(fd_);
+        throw std::runtime_error("Not a valid tick file: " + path);
+    }
+    ticks_ = reinterpret_cast<const TickRecord*>(bytes + sizeof(TickFileHeader));
+    names_ = reinterpret_cast<const TickSymbolName*>(bytes + header_->symbolTableOffset);
+}
+
+MappedTickFile::~MappedTickFile() {
+    if (data_ && data_ != MAP_FAILED) {
+        ::munmap(data_, length_);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+std::string MappedTickFile::symbol(uint32_t index) const {
+    if (index >= header_->symbolCount) {
+        throw std::out_of_range("Tick file symbol index out of range");
+    }
+    const char* name = names_[index].name;
+    return std::string(name, ::strnlen(name, sizeof(TickSymbolName::name)));
+}
+
+void MappedTickFile::release(const TickRecord* upTo) const {
+    static const size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    auto* base = static_cast<char*>(data_);
+    size_t bytes = static_cast<size_t>(reinterpret_cast<const char*>(upTo) - base);
+    bytes -= bytes % pageSize;
+    if (bytes > 0) {
+        ::madvise(base, bytes, MADV_DONTNEED);
+    }
+}
+
+uint64_t convertCsvToTickFile(const std::string& csvPath, const std::string& tickPath) {
+    std::ifstream in(csvPath);
+    if (!in) {
+        throw std::runtime_error("Cannot open CSV file: " + csvPath);
+    }
+
+    TickFileWriter writer(tickPath);
+    std::string line;
+    std::string symbol;
+    uint64_t lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        if (line.empty() || (lineNumber == 1 && !std::isdigit(static_cast<unsigned char>(line[0])))) {
+            continue;
+        }
+        for (char& c : line) {
+            if (c == ',') {
+                c = ' ';
+            }
+        }
+        std::istringstream fields(line);
+        MarketQuote quote{};
+        if (!(fields >> quote.timestampNs >> symbol >> quote.bidPrice >> quote.askPrice
+                     >> quote.bidSize >> quote.askSize >> quote.lastPrice >> quote.volume)) {
+            throw std::runtime_error("Malformed CSV line " + std::to_string(lineNumber) + " in " + csvPath);
+        }
+        writer.write(symbol, quote);
+    }
+    writer.finish();
+    return writer.tickCount();
+}
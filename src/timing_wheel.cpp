@@ -0,0 +1,185 @@
+#include "timing_wheel.hpp"
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+constexpr uint64_t kNoEvent = std::numeric_limits<uint64_t>::max();
+}
+
+timing_wheel_queue::timing_wheel_queue(std::chrono::nanoseconds tick, TimePoint origin)
+    : tick_(tick), origin_(origin) {
+    if (tick_.count() <= 0) {
+        throw std::invalid_argument("Timing wheel tick must be positive");
+    }
+}
+
+uint64_t timing_wheel_queue::ceilTick_(TimePoint time) const {
+    if (time <= origin_) {
+        return 0;
+    }
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(time - origin_).count();
+    return static_cast<uint64_t>((ns + tick_.count() - 1) / tick_.count());
+}
+
+uint64_t timing_wheel_queue::floorTick_(TimePoint time) const {
+    if (time <= origin_) {
+        return 0;
+    }
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(time - origin_).count();
+    return static_cast<uint64_t>(ns / tick_.count());
+}
+
+timing_wheel_queue::TimePoint timing_wheel_queue::timeOf_(uint64_t tick) const {
+    return origin_ + std::chrono::duration_cast<TimePoint::duration>(tick_ * tick);
+}
+
+void timing_wheel_queue::push(ScheduledTask task){
+    uint64_t tick = ceilTick_(task.executionTime);
+    place_(Entry{tick, std::move(task)});
+    ++size_;
+}
+
+void timing_wheel_queue::place_(Entry&& entry){
+    if (entry.tick <= current_) {
+        ready_.push_back(std::move(entry));
+        return;
+    }
+
+    uint64_t delta = entry.tick - current_;
+    if (delta >= kSpan) {
+        overflow_.push_back(std::move(entry));
+        return;
+    }
+
+    // Level is the first one whose span covers the delta
+    int level = 0;
+    while (delta >= (uint64_t{1} << (kSlotBits * (level + 1)))) {
+        ++level;
+    }
+    uint64_t slot = (entry.tick >> (kSlotBits * level)) & kSlotMask;
+    slots_[level][slot].push_back(std::move(entry));
+    occupied_[level] |= uint64_t{1} << slot;
+}
+
+uint64_t timing_wheel_queue::nextEventTick_() const {
+    uint64_t next = kNoEvent;
+
+    for (int level = 0; level < kLevels; ++level) {
+        if (occupied_[level] == 0) {
+            continue;
+        }
+        // Rotate so bit j is the slot j+1 positions after the current one
+        uint64_t base = current_ >> (kSlotBits * level);
+        int shift = static_cast<int>((base + 1) & kSlotMask);
+        uint64_t steps = static_cast<uint64_t>(std::countr_zero(std::rotr(occupied_[level], shift))) + 1;
+        uint64_t tick = level == 0 ? current_ + steps : (base + steps) << (kSlotBits * level);
+        next = std::min(next, tick);
+    }
+
+    for (const auto& entry : overflow_) {
+        // First tick at which the entry fits inside the wheel span
+        next = std::min(next, std::max(current_ + 1, entry.tick - (kSpan - 1)));
+    }
+
+    return next;
+}
+
+void timing_wheel_queue::drainReady_(std::vector<ScheduledTask>& out){
+    for (auto& entry : ready_) {
+        out.push_back(std::move(entry.task));
+    }
+    size_ -= ready_.size();
+    ready_.clear();
+}
+
+void timing_wheel_queue::processTick_(uint64_t tick, std::vector<ScheduledTask>& out){
+    if (!overflow_.empty()) {
+        scratch_.swap(overflow_);
+        for (auto& entry : scratch_) {
+            place_(std::move(entry));
+        }
+        scratch_.clear();
+    }
+
+    // Cascade higher levels first so re-placed entries land in slots processed below
+    for (int level = kLevels - 1; level >= 1; --level) {
+        uint64_t granularity = uint64_t{1} << (kSlotBits * level);
+        if (tick % granularity != 0) {
+            continue;
+        }
+        uint64_t slot = (tick >> (kSlotBits * level)) & kSlotMask;
+        if (!(occupied_[level] & (uint64_t{1} << slot))) {
+            continue;
+        }
+        scratch_.swap(slots_[level][slot]);
+        occupied_[level] &= ~(uint64_t{1} << slot);
+        for (auto& entry : scratch_) {
+            place_(std::move(entry));
+        }
+        scratch_.clear();
+    }
+
+    uint64_t slot = tick & kSlotMask;
+    if (occupied_[0] & (uint64_t{1} << slot)) {
+        auto& bucket = slots_[0][slot];
+        for (auto& entry : bucket) {
+            out.push_back(std::move(entry.task));
+        }
+        size_ -= bucket.size();
+        bucket.clear(); // keeps capacity for the next rotation
+        occupied_[0] &= ~(uint64_t{1} << slot);
+    }
+
+    drainReady_(out);
+}
+
+void timing_wheel_queue::popDue(TimePoint now, std::vector<ScheduledTask>& out){
+    uint64_t target = std::max(current_, floorTick_(now));
+
+    drainReady_(out);
+    while (true) {
+        uint64_t next = nextEventTick_();
+        if (next == kNoEvent || next > target) {
+            current_ = target; // no occupied slot in between, safe to jump
+            return;
+        }
+        current_ = next;
+        processTick_(next, out);
+    }
+}
+
+timing_wheel_queue::TimePoint timing_wheel_queue::nextDeadline() const {
+    if (!ready_.empty()) {
+        return timeOf_(current_);
+    }
+    uint64_t next = nextEventTick_();
+    return next == kNoEvent ? TimePoint::max() : timeOf_(next);
+}
+
+size_t timing_wheel_queue::purgeStale(){
+    auto purge = [](std::vector<Entry>& entries) {
+        auto end = std::remove_if(entries.begin(), entries.end(),
+                                  [](const Entry& entry) { return !entry.task.isLive(); });
+        size_t removed = static_cast<size_t>(entries.end() - end);
+        entries.erase(end, entries.end());
+        return removed;
+    };
+
+    size_t removed = purge(ready_) + purge(overflow_);
+    for (int level = 0; level < kLevels; ++level) {
+        uint64_t bits = occupied_[level];
+        while (bits != 0) {
+            int slot = std::countr_zero(bits);
+            bits &= bits - 1;
+            auto& bucket = slots_[level][slot];
+            removed += purge(bucket);
+            if (bucket.empty()) {
+                occupied_[level] &= ~(uint64_t{1} << slot);
+            }
+        }
+    }
+    size_ -= removed;
+    return removed;
+}
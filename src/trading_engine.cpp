@@ -1,15 +1,259 @@
 #include "trading_engine.hpp"
+#include "async_logger.hpp"
 #include <random>
-#include <iostream>
-#include <iomanip>
+#include <stdexcept>
+#include <charconv>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <thread>
+#include <unordered_map>
 
-std::string generateOrderId() {
-    static int counter = 0;
-    return "ORDER_" + std::to_string(++counter);
+namespace {
+constexpr std::string_view kOrderIdPrefix = "ORDER_";
+constexpr double kVarianceDecay = 0.94;  // per coalesced sample
+constexpr uint32_t kMinVolatilitySamples = 8;
+constexpr double kMinCarryShares = 1e-6; // smaller book shortfalls are dropped
+// A last chunk the book keeps short is retried for this many intervals past
+// the horizon; then the order fails with the rest unfilled
+constexpr int64_t kMaxOverrunIntervals = 10;
+
+template <int Intervals>
+std::vector<double> fixedShape(const AlmgrenChrissModel& model) {
+    auto shape = model.fixedScheduleShape<Intervals>();
+    return {shape.begin(), shape.end()};
+}
+
+// The interval counts calculateOptimalIntervalCount_ hands out get unrolled
+// schedules; anything else goes through the runtime-length kernel
+std::vector<double> scheduleShapeFor(const AlmgrenChrissModel& model, int intervals) {
+    switch (intervals) {
+    case 5: return fixedShape<5>(model);
+    case 10: return fixedShape<10>(model);
+    case 20: return fixedShape<20>(model);
+    case 50: return fixedShape<50>(model);
+    case 100: return fixedShape<100>(model);
+    default: return model.scheduleShape(intervals);
+    }
+}
+
+// Model setup is pure per order: fn(begin, end) runs over contiguous blocks
+// of [0, count) on as many threads as there are blocks of a useful size
+template <typename Fn>
+void forEachOrderBlock(size_t count, Fn&& fn) {
+    constexpr size_t kOrdersPerThread = 256;
+    const size_t workers = std::clamp<size_t>(count / kOrdersPerThread, 1,
+                                              std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::exception_ptr> errors(workers);
+    auto build = [&](size_t w) {
+        try {
+            fn(count * w / workers, count * (w + 1) / workers);
+        } catch (...) {
+            errors[w] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (size_t w = 1; w < workers; ++w) {
+        pool.emplace_back(build, w);
+    }
+    build(0);
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+// An order as the journal describes it, before its model is rebuilt
+struct RecoveredOrder {
+    OrderHandle handle{kInvalidOrderHandle};
+    TradingEngine::Order order;
+    bool jointSchedule{false};
+    std::vector<double> schedule;
+    OrderStatus status{OrderStatus::PENDING};
+    size_t filledChunks{0};
+    uint32_t modelSteps{0};
+    double executedShares{0.0};          // over history
+    double averageExecutionPrice{0.0};
+    std::vector<FillRecord> history;     // as of the snapshot
+    std::vector<FillRecord> fills;       // journaled after it
+    uint64_t sequence{0};
+};
+
+// Reused per thread by the single-record journal paths
+order_journal::batch& scratchRecords() {
+    thread_local order_journal::batch records;
+    records.clear();
+    return records;
+}
+
+JournalSubmit journalHeaderFor(const TradingEngine::Order& order, bool jointSchedule, size_t scheduleLength) {
+    JournalSubmit submit{};
+    submit.totalShares = order.totalShares;
+    submit.isBuy = order.isBuy ? 1 : 0;
+    submit.jointSchedule = jointSchedule ? 1 : 0;
+    submit.symbolLength = static_cast<uint16_t>(order.symbol.size());
+    submit.initialPrice = order.initialPrice;
+    submit.timeHorizon = order.timeHorizon;
+    submit.riskAversion = order.riskAversion;
+    submit.numIntervals = order.numIntervals;
+    submit.scheduleLength = static_cast<uint32_t>(scheduleLength);
+    return submit;
+}
+
+// Reads a journal payload front to back. Checksums already passed, so a
+// record shorter than its fields is a format mismatch, not a torn write.
+class payload_reader {
+public:
+    explicit payload_reader(const JournalRecord& record)
+        : at_(record.payload), end_(record.payload + record.length) {}
+
+    template <typename T>
+    T read() {
+        T value;
+        bytes(&value, sizeof(T));
+        return value;
+    }
+
+    void bytes(void* out, size_t size) {
+        if (static_cast<size_t>(end_ - at_) < size) {
+            throw std::runtime_error("Journal record shorter than its contents");
+        }
+        if (size > 0) {
+            std::memcpy(out, at_, size);
+        }
+        at_ += size;
+    }
+
+    std::string string(size_t length) {
+        std::string value(length, '\0');
+        bytes(value.data(), length);
+        return value;
+    }
+
+    std::vector<double> doubles(size_t count) {
+        std::vector<double> values(count);
+        bytes(values.data(), count * sizeof(double));
+        return values;
+    }
+
+private:
+    const char* at_;
+    const char* end_;
+};
+
+// initialize() config file: one "<thread>.<setting> = <value>" per line,
+// '#' starts a comment. Threads: timer, workers, dispatcher, journal,
+// logger. Settings: cpus (e.g. 2,4-6) and priority (SCHED_FIFO, 1-99).
+std::map<std::string, ThreadPlacement> readThreadConfig(const std::string& path) {
+    static const std::string kThreads[] = {"timer", "workers", "dispatcher", "journal", "logger"};
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Cannot open engine config " + path);
+    }
+    auto trim = [](std::string text) {
+        size_t first = text.find_first_not_of(" \t\r");
+        size_t last = text.find_last_not_of(" \t\r");
+        return first == std::string::npos ? std::string() : text.substr(first, last - first + 1);
+    };
+
+    std::map<std::string, ThreadPlacement> placements;
+    std::string line;
+    for (int number = 1; std::getline(in, line); ++number) {
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) {
+            continue;
+        }
+        auto fail = [&](const std::string& message) {
+            return std::invalid_argument(path + ":" + std::to_string(number) + ": " + message);
+        };
+        size_t equals = line.find('=');
+        size_t dot = line.find('.');
+        if (equals == std::string::npos || dot == std::string::npos || dot > equals) {
+            throw fail("expected <thread>.<setting> = <value>");
+        }
+        std::string thread = trim(line.substr(0, dot));
+        std::string setting = trim(line.substr(dot + 1, equals - dot - 1));
+        std::string value = trim(line.substr(equals + 1));
+        if (std::find(std::begin(kThreads), std::end(kThreads), thread) == std::end(kThreads)) {
+            throw fail("unknown thread '" + thread + "'");
+        }
+        ThreadPlacement& placement = placements[thread];
+        try {
+            if (setting == "cpus") {
+                placement.cpus = thread_tuning::parseCpuList(value);
+            } else if (setting == "priority") {
+                size_t used = 0;
+                placement.fifoPriority = std::stoi(value, &used);
+                if (used != value.size() || placement.fifoPriority < 0 || placement.fifoPriority > 99) {
+                    throw std::invalid_argument("priority must be 0-99");
+                }
+            } else {
+                throw std::invalid_argument("unknown setting '" + setting + "'");
+            }
+        } catch (const std::logic_error& e) {
+            throw fail(e.what());
+        }
+    }
+    return placements;
+}
+
+DispatcherConfig dispatcherConfigFor(const EngineConfig& config) {
+    DispatcherConfig dispatch = config.dispatcher;
+    if (config.scheduler.clock && config.scheduler.clock->isSimulated()) {
+        dispatch.async = false; // keep simulated runs single-threaded
+    }
+    return dispatch;
+}
+}
+
+OrderHandle TradingEngine::handleOf(const std::string& orderId) {
+    if (orderId.compare(0, kOrderIdPrefix.size(), kOrderIdPrefix) != 0) {
+        return kInvalidOrderHandle;
+    }
+    OrderHandle handle = kInvalidOrderHandle;
+    const char* first = orderId.data() + kOrderIdPrefix.size();
+    const char* last = orderId.data() + orderId.size();
+    auto [ptr, ec] = std::from_chars(first, last, handle);
+    if (ec != std::errc{} || ptr != last) {
+        return kInvalidOrderHandle;
+    }
+    return handle;
+}
+
+std::string TradingEngine::orderIdOf(OrderHandle handle) {
+    return std::string(kOrderIdPrefix) + std::to_string(handle);
 }
 
-TradingEngine::TradingEngine() {
+TradingEngine::TradingEngine()
+    : TradingEngine(EngineConfig{}) {}
+
+TradingEngine::TradingEngine(const EngineConfig& config)
+    : modelSeed_(config.modelSeed),
+      reoptimizeThreshold_(config.reoptimizeThreshold),
+      marketDataCoalesce_(config.marketDataCoalesce),
+      chunkTrigger_(config.chunkTrigger),
+      releaseWindow_(std::clamp(config.releaseWindow, 0.0, 1.0)),
+      symbols_(config.maxSymbols),
+      quotes_(config.maxSymbols),
+      book_(quotes_, config.book),
+      symbolStates_(new SymbolState[config.maxSymbols]),
+      scheduleCache_(config.scheduleCacheCapacity),
+      dispatcher_(dispatcherConfigFor(config),
+          [this](const EngineEvent* events, size_t count) { deliverEvents_(events, count); }),
+      scheduler_(config.scheduler) {
+    activeOrders_.setLockWaitHistogram(&lockWait_);
+    dispatcher_.start();
     scheduler_.start();
+    if (!config.journal.directory.empty()) {
+        recover_(config.journal);
+    }
 }
 
 TradingEngine::~TradingEngine() {
@@ -17,23 +261,89 @@ TradingEngine::~TradingEngine() {
 }
 
 void TradingEngine::initialize(const std::string& configPath) {
-    (void)configPath;
-    std::cout << "TradingEngine initialized" << std::endl;
+    std::map<std::string, ThreadPlacement> placements;
+    if (!configPath.empty()) {
+        placements = readThreadConfig(configPath);
+    }
+
+    std::map<std::string, std::vector<NamedThread>> groups;
+    for (NamedThread& thread : scheduler_.threads()) {
+        groups[thread.name == "ac-timer" ? "timer" : "workers"].push_back(std::move(thread));
+    }
+    groups["dispatcher"] = dispatcher_.threads();
+    if (journal_) {
+        groups["journal"] = journal_->threads();
+    }
+    groups["logger"] = async_logger::instance().threads();
+
+    std::vector<ThreadReport> reports;
+    for (const auto& [group, placement] : placements) {
+        if (groups[group].empty()) {
+            AC_LOG_WARN("No {} thread in this configuration; its settings are ignored", group);
+        }
+    }
+    for (const auto& [group, threads] : groups) {
+        auto it = placements.find(group);
+        ThreadPlacement placement = it == placements.end() ? ThreadPlacement{} : it->second;
+        for (size_t i = 0; i < threads.size(); ++i) {
+            ThreadPlacement own = placement;
+            // Enough CPUs for every worker: one each, so none of them migrate
+            if (group == "workers" && placement.cpus.size() >= threads.size()) {
+                own.cpus = {placement.cpus[i]};
+            }
+            reports.push_back(thread_tuning::apply(threads[i], own));
+        }
+    }
+
+    for (const ThreadReport& report : reports) {
+        if (report.error.empty()) {
+            AC_LOG_INFO("Thread {}", report.describe());
+        } else {
+            AC_LOG_WARN("Thread {}", report.describe());
+        }
+    }
+    {
+        std::lock_guard lock(threadReportMutex_);
+        threadReports_ = std::move(reports);
+    }
+    AC_LOG_INFO("TradingEngine initialized");
+}
+
+std::vector<ThreadReport> TradingEngine::threadReport() const {
+    std::lock_guard lock(threadReportMutex_);
+    return threadReports_;
 }
 
 void TradingEngine::shutdown() {
     scheduler_.stop();
-    std::cout << "TradingEngine shutdown" << std::endl;
+    dispatcher_.stop();
+    if (journal_) {
+        journal_->commit();
+    }
+    AC_LOG_INFO("TradingEngine shutdown");
 }
 
-std::string TradingEngine::submitOrder(const Order& order) {
-    std::lock_guard lock(orderMutex_);
-    
-    std::string orderId = generateOrderId();
-    
-    OrderExecutionContext context;
+void TradingEngine::validateOrder_(const Order& order) {
+    if (order.symbol.empty()) {
+        throw std::invalid_argument("Order symbol must not be empty");
+    }
+    if (order.totalShares <= 0) {
+        throw std::invalid_argument("Order totalShares must be positive");
+    }
+    if (order.initialPrice <= 0.0 || order.timeHorizon <= 0.0) {
+        throw std::invalid_argument("Order initialPrice and timeHorizon must be positive");
+    }
+    if (order.riskAversion < 0.0) {
+        throw std::invalid_argument("Order riskAversion must not be negative");
+    }
+}
+
+void TradingEngine::buildOrderContext_(OrderExecutionContext& context, OrderHandle handle, SymbolId symbol,
+                                       const Order& order, const std::vector<double>* presetSchedule) {
+    context.handle = handle;
+    context.symbolId = symbol;
     context.order = order;
-    context.order.orderId = orderId;
+    context.order.orderId = orderIdOf(handle);
     
     // Use EVEN smaller impact parameters for 50,000 shares
     context.model.setParameters(
@@ -45,83 +355,541 @@ std::string TradingEngine::submitOrder(const Order& order) {
         static_cast<double>(order.totalShares),
         order.timeHorizon
     );
+    if (modelSeed_) {
+        context.model.seed(*modelSeed_, handle);
+    }
+    context.scheduleSigma = context.model.getSigma();
     
+    if (presetSchedule) {
+        context.optimalSchedule = *presetSchedule;
+        context.jointSchedule = true;
+        return;
+    }
     // Calculate optimal execution schedule
     calculateOptimalSchedule_(context);
+}
+
+std::string TradingEngine::submitOrder(const Order& order) {
+    validateOrder_(order);
+    OrderHandle handle = activeOrders_.allocate();
     
-    activeOrders_[orderId] = std::move(context);
+    // Model and schedule are built before touching the order table
+    OrderExecutionContext context;
+    buildOrderContext_(context, handle, symbols_.intern(order.symbol), order);
+    std::string orderId = context.order.orderId;
+    
+    SymbolId symbolId = context.symbolId;
+    {
+        std::shared_lock<std::shared_mutex> gate(submitGate_, std::defer_lock);
+        if (journal_) {
+            gate.lock();
+            order_journal::batch& records = scratchRecords();
+            journalSubmit_(records, context);
+            journal_->append(records);
+        }
+        activeOrders_.insert(handle, std::move(context));
+    }
+
+    // Registered after insert so a recompute never sees a handle it can't find
+    SymbolState& state = symbolStates_[symbolId];
+    {
+        std::lock_guard lock(state.ordersMutex);
+        state.orders.push_back(handle);
+    }
+    state.liveOrders.fetch_add(1, std::memory_order_relaxed);
     
-    std::cout << "Submitted order: " << orderId 
-              << " for " << order.totalShares << " shares of " << order.symbol << std::endl;
+    AC_LOG_INFO("Submitted order: {} for {} shares of {}", orderId, order.totalShares, order.symbol);
     
     return orderId;
 }
 
-void TradingEngine::cancelOrder(const std::string& orderId) {
-    std::lock_guard lock(orderMutex_);
-    
-    auto it = activeOrders_.find(orderId);
-    if (it != activeOrders_.end()) {
-        it->second.status = OrderStatus::CANCELLED;
-        std::cout << "Cancelled order: " << orderId << std::endl;
+std::vector<std::string> TradingEngine::submitOrders(const std::vector<Order>& orders) {
+    return submitOrders_(orders, nullptr);
+}
+
+std::vector<std::string> TradingEngine::submitBasket(const BasketOrder& basket) {
+    const size_t legCount = basket.legs.size();
+    if (legCount == 0) {
+        throw std::invalid_argument("Basket has no legs");
+    }
+    if (basket.timeHorizon <= 0.0 || basket.riskAversion < 0.0) {
+        throw std::invalid_argument("Basket timeHorizon must be positive and riskAversion not negative");
     }
+
+    std::vector<Order> legs = basket.legs;
+    std::vector<double> positions(legCount);
+    int largest = 0;
+    for (size_t i = 0; i < legCount; ++i) {
+        legs[i].timeHorizon = basket.timeHorizon;
+        legs[i].riskAversion = basket.riskAversion;
+        try {
+            validateOrder_(legs[i]);
+        } catch (const std::invalid_argument& e) {
+            throw std::invalid_argument("Leg " + std::to_string(i) + " of basket: " + e.what());
+        }
+        positions[i] = legs[i].isBuy ? legs[i].totalShares : -legs[i].totalShares;
+        largest = std::max(largest, legs[i].totalShares);
+    }
+    const int intervals = basket.numIntervals > 0 ? basket.numIntervals : calculateOptimalIntervalCount_(largest);
+    for (Order& leg : legs) {
+        leg.numIntervals = intervals;
+    }
+
+    // The factorization runs outside the cache lock so other baskets are not
+    // held up behind it; if another thread cached the same basket meanwhile,
+    // its model is kept and ours is dropped
+    BasketModelCache& cache = basketModel_;
+    auto matches = [&] {
+        return cache.model && cache.model->assets() == legCount && cache.riskAversion == basket.riskAversion &&
+               cache.timeHorizon == basket.timeHorizon && cache.covariance == basket.covariance &&
+               cache.impact == basket.impact;
+    };
+    std::shared_ptr<const PortfolioLiquidationModel> model;
+    {
+        std::lock_guard lock(cache.mutex);
+        if (matches()) {
+            model = cache.model;
+        }
+    }
+    if (!model) {
+        auto fresh = std::make_shared<PortfolioLiquidationModel>();
+        fresh->setParameters(basket.covariance, basket.impact, basket.riskAversion, positions, basket.timeHorizon);
+        std::lock_guard lock(cache.mutex);
+        if (matches()) {
+            model = cache.model;
+        } else {
+            cache.covariance = basket.covariance;
+            cache.impact = basket.impact;
+            cache.riskAversion = basket.riskAversion;
+            cache.timeHorizon = basket.timeHorizon;
+            cache.model = fresh;
+            model = std::move(fresh);
+        }
+    }
+    std::vector<double> joint = model->calculateOptimalSchedule(positions, intervals);
+
+    // A leg's joint path may overshoot (trade through its target while it
+    // hedges others); orders only trade one way, so each leg follows the
+    // running maximum of its progress, capped at its size
+    std::vector<std::vector<double>> schedules(legCount, std::vector<double>(intervals));
+    for (size_t i = 0; i < legCount; ++i) {
+        const double side = legs[i].isBuy ? 1.0 : -1.0;
+        const double total = legs[i].totalShares;
+        double progress = 0.0;
+        double reached = 0.0;
+        for (int k = 0; k < intervals; ++k) {
+            progress += side * joint[static_cast<size_t>(k) * legCount + i];
+            double level = k + 1 == intervals ? total : std::max(reached, std::min(progress, total));
+            schedules[i][k] = level - reached;
+            reached = level;
+        }
+    }
+    return submitOrders_(legs, &schedules);
 }
 
-OrderStatus TradingEngine::getOrderStatus(const std::string& orderId) const {
-    std::lock_guard lock(orderMutex_);
-    
-    auto it = activeOrders_.find(orderId);
-    if (it != activeOrders_.end()) {
-        return it->second.status;
+std::vector<std::string> TradingEngine::submitOrders_(const std::vector<Order>& orders,
+                                                      const std::vector<std::vector<double>>* presetSchedules) {
+    const size_t count = orders.size();
+    std::vector<SymbolId> symbolIds(count);
+    for (size_t i = 0; i < count; ++i) {
+        try {
+            validateOrder_(orders[i]);
+        } catch (const std::invalid_argument& e) {
+            throw std::invalid_argument("Order " + std::to_string(i) + " in batch: " + e.what());
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        symbolIds[i] = symbols_.intern(orders[i].symbol);
+    }
+    if (count == 0) {
+        return {};
+    }
+
+    const OrderHandle first = activeOrders_.allocate(count);
+    std::vector<std::pair<OrderHandle, OrderExecutionContext>> entries(count);
+
+    forEachOrderBlock(count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            OrderHandle handle = first + static_cast<OrderHandle>(i);
+            entries[i].first = handle;
+            buildOrderContext_(entries[i].second, handle, symbolIds[i], orders[i],
+                               presetSchedules ? &(*presetSchedules)[i] : nullptr);
+        }
+    });
+
+    {
+        // The whole batch goes to the journal as one append
+        std::shared_lock<std::shared_mutex> gate(submitGate_, std::defer_lock);
+        if (journal_) {
+            gate.lock();
+            order_journal::batch records;
+            for (auto& entry : entries) {
+                journalSubmit_(records, entry.second);
+            }
+            journal_->append(records);
+        }
+        activeOrders_.insertBatch(std::move(entries));
+    }
+
+    std::vector<std::pair<SymbolId, OrderHandle>> bySymbol(count);
+    for (size_t i = 0; i < count; ++i) {
+        bySymbol[i] = {symbolIds[i], first + static_cast<OrderHandle>(i)};
+    }
+    registerWithSymbols_(bySymbol);
+
+    std::vector<std::string> orderIds;
+    orderIds.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        orderIds.push_back(orderIdOf(first + static_cast<OrderHandle>(i)));
+    }
+
+    AC_LOG_INFO("Submitted {} orders: {} .. {}", count, orderIds.front(), orderIds.back());
+    return orderIds;
+}
+
+// Adds live orders to their symbols' lists, one lock per symbol
+void TradingEngine::registerWithSymbols_(std::vector<std::pair<SymbolId, OrderHandle>>& bySymbol) {
+    const size_t count = bySymbol.size();
+    std::sort(bySymbol.begin(), bySymbol.end());
+    for (size_t begin = 0; begin < count;) {
+        SymbolState& state = symbolStates_[bySymbol[begin].first];
+        size_t end = begin;
+        {
+            std::lock_guard lock(state.ordersMutex);
+            while (end < count && bySymbol[end].first == bySymbol[begin].first) {
+                state.orders.push_back(bySymbol[end].second);
+                ++end;
+            }
+        }
+        state.liveOrders.fetch_add(static_cast<uint32_t>(end - begin), std::memory_order_relaxed);
+        begin = end;
     }
-    return OrderStatus::FAILED;
+}
+
+void TradingEngine::cancelOrder(const std::string& orderId) {
+    cancelOrder(handleOf(orderId));
+}
+
+void TradingEngine::cancelOrder(OrderHandle handle) {
+    activeOrders_.with(handle, [&](OrderExecutionContext& context) {
+        if (!isTerminal_(context.status)) {
+            retireOrder_(context);
+        }
+        context.status = OrderStatus::CANCELLED;
+        journalStatus_(context);
+        if (context.startedAt && !context.finishedAt) {
+            context.finishedAt = scheduler_.now();
+        }
+        scheduler_.cancel(context.pendingChunk); // drop the queued chunk outright
+        AC_LOG_INFO("Cancelled order: {}", context.order.orderId);
+    });
+}
+
+OrderStatus TradingEngine::getOrderStatus(const std::string& orderId) const {
+    return getOrderStatus(handleOf(orderId));
+}
+
+OrderStatus TradingEngine::getOrderStatus(OrderHandle handle) const {
+    OrderStatus status = OrderStatus::FAILED;
+    activeOrders_.with(handle, [&](const OrderExecutionContext& context) {
+        status = context.status;
+    });
+    return status;
 }
 
 void TradingEngine::startExecution(const std::string& orderId) {
-    std::lock_guard lock(orderMutex_);
-    
-    auto it = activeOrders_.find(orderId);
-    if (it == activeOrders_.end()) {
-        std::cout << "Order not found: " << orderId << std::endl;
-        return;
+    startExecution(handleOf(orderId));
+}
+
+void TradingEngine::startExecution(OrderHandle handle) {
+    bool found = activeOrders_.with(handle, [&](OrderExecutionContext& context) {
+        context.status = OrderStatus::ACTIVE;
+        journalStatus_(context);
+        auto now = scheduler_.now();
+        if (!context.startedAt) {
+            context.startedAt = now;
+        }
+        anchorSchedule_(context, now);
+        AC_LOG_INFO("Starting execution for: {}", context.order.orderId);
+        
+        // Schedule the first chunk
+        scheduleNextChunk_(context);
+    });
+    if (!found) {
+        AC_LOG_WARN("Order not found: {}", orderIdOf(handle));
     }
-    
-    it->second.status = OrderStatus::ACTIVE;
-    std::cout << "Starting execution for: " << orderId << std::endl;
-    
-    // Schedule the first chunk
-    scheduleNextChunk_(orderId);
 }
 
-void TradingEngine::pauseExecution(const std::string& orderId) {
-    std::lock_guard lock(orderMutex_);
-    
-    auto it = activeOrders_.find(orderId);
-    if (it != activeOrders_.end()) {
-        it->second.status = OrderStatus::PAUSED;
-        std::cout << "Paused execution for: " << orderId << std::endl;
+void TradingEngine::startExecutions(const std::vector<std::string>& orderIds) {
+    std::vector<OrderHandle> handles;
+    handles.reserve(orderIds.size());
+    for (const auto& orderId : orderIds) {
+        handles.push_back(handleOf(orderId));
     }
+    startExecutions(handles);
+}
+
+void TradingEngine::startExecutions(const std::vector<OrderHandle>& handles) {
+    size_t started = 0;
+    auto now = scheduler_.now();
+    activeOrders_.withEach(handles, [&](OrderHandle, OrderExecutionContext& context) {
+        context.status = OrderStatus::ACTIVE;
+        journalStatus_(context);
+        if (!context.startedAt) {
+            context.startedAt = now;
+        }
+        anchorSchedule_(context, now);
+        scheduleNextChunk_(context);
+        ++started;
+    });
+    AC_LOG_INFO("Starting execution for {} of {} orders", started, handles.size());
+}
+
+void TradingEngine::pauseExecution(const std::string& orderId) {
+    pauseExecution(handleOf(orderId));
+}
+
+void TradingEngine::pauseExecution(OrderHandle handle) {
+    activeOrders_.with(handle, [&](OrderExecutionContext& context) {
+        context.status = OrderStatus::PAUSED;
+        journalStatus_(context);
+        // The queued chunk never ran, so resume should schedule it again
+        if (scheduler_.cancel(context.pendingChunk) && context.currentScheduleIndex > 0) {
+            context.currentScheduleIndex--;
+        }
+        AC_LOG_INFO("Paused execution for: {}", context.order.orderId);
+    });
 }
 
 void TradingEngine::resumeExecution(const std::string& orderId) {
-    std::lock_guard lock(orderMutex_);
-    
-    auto it = activeOrders_.find(orderId);
-    if (it != activeOrders_.end() && it->second.status == OrderStatus::PAUSED) {
-        it->second.status = OrderStatus::ACTIVE;
-        std::cout << "Resumed execution for: " << orderId << std::endl;
-        scheduleNextChunk_(orderId);
-    }
+    resumeExecution(handleOf(orderId));
+}
+
+void TradingEngine::resumeExecution(OrderHandle handle) {
+    activeOrders_.with(handle, [&](OrderExecutionContext& context) {
+        if (context.status == OrderStatus::PAUSED) {
+            context.status = OrderStatus::ACTIVE;
+            journalStatus_(context);
+            AC_LOG_INFO("Resumed execution for: {}", context.order.orderId);
+            anchorSchedule_(context, scheduler_.now());
+            scheduleNextChunk_(context);
+        }
+    });
+}
+
+SymbolId TradingEngine::internSymbol(const std::string& symbol) {
+    return symbols_.intern(symbol);
 }
 
 void TradingEngine::onMarketDataUpdate(const MarketData& data) {
-    std::lock_guard lock(marketDataMutex_);
-    currentMarketData_[data.symbol] = data;
-    // adjust schedules based on market data
+    // Known symbols resolve lock-free; only a first sighting takes the intern lock
+    SymbolId id = symbols_.find(data.symbol);
+    if (id == kInvalidSymbol) {
+        id = symbols_.intern(data.symbol);
+    }
+    onMarketDataUpdate(id, MarketQuote::from(data));
 }
 
-void TradingEngine::onExecutionReport(const ExecutionReport& report) {
-    (void)report; 
+void TradingEngine::onMarketDataUpdate(SymbolId symbol, const MarketQuote& quote) {
+    // Ids come from callers (replays, other engines' tables); one from
+    // elsewhere must not write past the preallocated slots
+    if (symbol >= quotes_.capacity()) {
+        throw std::out_of_range("Unknown symbol id " + std::to_string(symbol));
+    }
+    quotes_.publish(symbol, quote);
+
+    SymbolState& state = symbolStates_[symbol];
+    if (state.liveOrders.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+
+    // Event-driven chunks: one release pass per burst, queued for now on the
+    // symbol's worker so it never races the chunks themselves
+    if (chunkTrigger_ == ChunkTrigger::MarketData && (quote.bidSize > 0 || quote.askSize > 0) &&
+        !state.releasePending.load(std::memory_order_relaxed) &&
+        !state.releasePending.exchange(true, std::memory_order_acq_rel)) {
+        scheduler_.scheduleAt(scheduler_.now(), [this, symbol]() {
+            this->releaseChunks_(symbol);
+        }, symbolAffinity_(symbol));
+    }
+
+    // A burst of ticks queues one recompute per window; it reads whatever quote
+    // is latest when it runs
+    if (state.recomputePending.load(std::memory_order_relaxed) ||
+        state.recomputePending.exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+    scheduler_.scheduleAfter(marketDataCoalesce_, [this, symbol]() {
+        this->recomputeSymbol_(symbol);
+    }, symbolAffinity_(symbol));
+}
+
+void TradingEngine::recomputeSymbol_(SymbolId symbol) {
+    SymbolState& state = symbolStates_[symbol];
+    // Cleared first: ticks arriving from here on schedule the next window
+    state.recomputePending.store(false, std::memory_order_release);
+
+    MarketQuote quote;
+    if (!quotes_.read(symbol, quote) || !updateEstimates_(state, quote)) {
+        return;
+    }
+
+    std::vector<OrderHandle> orders;
+    {
+        std::lock_guard lock(state.ordersMutex);
+        orders = state.orders;
+    }
+
+    std::vector<OrderHandle> finished;
+    for (OrderHandle handle : orders) {
+        if (!adjustScheduleDynamically_(handle, state)) {
+            finished.push_back(handle);
+        }
+    }
+
+    if (!finished.empty()) {
+        std::lock_guard lock(state.ordersMutex);
+        std::erase_if(state.orders, [&](OrderHandle handle) {
+            return std::find(finished.begin(), finished.end(), handle) != finished.end();
+        });
+    }
+}
+
+void TradingEngine::releaseChunks_(SymbolId symbol) {
+    SymbolState& state = symbolStates_[symbol];
+    state.releasePending.store(false, std::memory_order_release);
+
+    MarketQuote quote;
+    if (!quotes_.read(symbol, quote)) {
+        return;
+    }
+    std::vector<OrderHandle> orders;
+    {
+        std::lock_guard lock(state.ordersMutex);
+        orders = state.orders;
+    }
+
+    // Moving the queued chunk up, rather than running it here, leaves exactly
+    // one task per chunk whichever of tick and deadline comes first. A tick
+    // before the chunk's window opens moves it to the opening, since no later
+    // tick may come to show the same liquidity again
+    constexpr auto kReleased = std::chrono::steady_clock::time_point::max();
+    auto now = scheduler_.now();
+    activeOrders_.withEach(orders, [&](OrderHandle, OrderExecutionContext& context) {
+        bool liquidity = context.order.isBuy ? quote.askSize > 0 : quote.bidSize > 0;
+        if (liquidity && context.status == OrderStatus::ACTIVE && context.releaseAt != kReleased &&
+            scheduler_.reschedule(context.pendingChunk, std::max(now, context.releaseAt))) {
+            context.releaseAt = kReleased;
+            releasedChunks_.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+}
+
+bool TradingEngine::updateEstimates_(SymbolState& state, const MarketQuote& quote) {
+    double mid = 0.5 * (quote.bidPrice + quote.askPrice);
+    if (mid <= 0.0 || quote.askPrice < quote.bidPrice) {
+        return false; // one-sided or crossed book
+    }
+    state.spread = (quote.askPrice - quote.bidPrice) / mid;
+
+    // Feed timestamps are epoch nanoseconds; no engine clock shares that
+    // origin, so a tick without one only moves the spread. Its mid is not
+    // kept either, or the next return would span an unknown interval.
+    const int64_t timestampNs = quote.timestampNs;
+    if (timestampNs <= 0) {
+        return true;
+    }
+
+    // Squared log return per second of elapsed time estimates sigma^2 in the
+    // same units the model uses (fractional move per sqrt(second))
+    if (state.lastMid > 0.0 && timestampNs > state.lastTimestampNs) {
+        double logReturn = std::log(mid / state.lastMid);
+        double seconds = (timestampNs - state.lastTimestampNs) * 1e-9;
+        double sample = logReturn * logReturn / seconds;
+        state.variance = state.samples == 0 ? sample
+                                            : kVarianceDecay * state.variance + (1.0 - kVarianceDecay) * sample;
+        ++state.samples;
+    }
+    state.lastMid = mid;
+    state.lastTimestampNs = timestampNs;
+    return true;
+}
+
+bool TradingEngine::adjustScheduleDynamically_(OrderHandle handle, const SymbolState& state) {
+    bool live = false;
+    activeOrders_.with(handle, [&](OrderExecutionContext& context) {
+        if (isTerminal_(context.status)) {
+            return;
+        }
+        live = true;
+        // A basket leg's schedule only makes sense next to the other legs'
+        if (context.jointSchedule) {
+            return;
+        }
+
+        // The chunk at currentScheduleIndex - 1 is already queued with its size;
+        // only what comes after it can still change
+        size_t next = context.currentScheduleIndex;
+        size_t total = context.optimalSchedule.size();
+        if (next >= total) {
+            return;
+        }
+
+        double sigma = context.scheduleSigma;
+        if (state.samples >= kMinVolatilitySamples && state.variance > 0.0) {
+            sigma = std::sqrt(state.variance);
+        }
+        double spread = state.spread;
+        if (context.referenceSpread <= 0.0 && spread > 0.0) {
+            context.referenceSpread = spread;
+            context.scheduleSpread = spread;
+        }
+
+        double sigmaMove = std::abs(sigma / context.scheduleSigma - 1.0);
+        double spreadMove = context.scheduleSpread > 0.0 && spread > 0.0
+                                ? std::abs(spread / context.scheduleSpread - 1.0) : 0.0;
+        if (std::max(sigmaMove, spreadMove) < reoptimizeThreshold_) {
+            return;
+        }
+
+        // Temporary impact scales with the cost of crossing the spread
+        double eta = context.model.getEta();
+        if (context.referenceSpread > 0.0 && spread > 0.0) {
+            eta *= spread / context.referenceSpread;
+        }
+
+        double remainingShares = 0.0;
+        for (size_t i = next; i < total; ++i) {
+            remainingShares += context.optimalSchedule[i];
+        }
+        size_t intervals = total - next;
+        double remainingTime = context.order.timeHorizon * static_cast<double>(intervals) / total;
+
+        std::vector<double> tail = context.model.remainingSchedule(
+            remainingShares, remainingTime, static_cast<int>(intervals), sigma, eta);
+        std::copy(tail.begin(), tail.end(), context.optimalSchedule.begin() + next);
+        journalReschedule_(context, next);
+
+        context.scheduleSigma = sigma;
+        context.scheduleSpread = spread;
+        scheduleAdjustments_.fetch_add(1, std::memory_order_relaxed);
+
+        AC_LOG_INFO("Re-optimized {}: {} chunks left, sigma {}, eta {}", context.order.orderId, intervals, sigma, eta);
+    });
+    return live;
+}
+
+bool TradingEngine::getMarketQuote(SymbolId symbol, MarketQuote& out) const {
+    return quotes_.read(symbol, out);
+}
+
+std::optional<MarketData> TradingEngine::getMarketData(const std::string& symbol) const {
+    SymbolId id = symbols_.find(symbol);
+    MarketQuote quote;
+    if (id == kInvalidSymbol || !quotes_.read(id, quote)) {
+        return std::nullopt;
+    }
+    return quote.toMarketData(symbol);
 }
 
 int TradingEngine::calculateOptimalIntervalCount_(int totalShares) {
@@ -140,7 +908,10 @@ void TradingEngine::calculateOptimalSchedule_(OrderExecutionContext& context) {
         numIntervals = calculateOptimalIntervalCount_(context.order.totalShares);
     }
 
-    context.optimalSchedule = context.model.calculateOptimalSchedule(numIntervals); // 5 intervals
+    const AlmgrenChrissModel& model = context.model;
+    ScheduleKey key{model.getKappa(), model.getTimeHorizon(), numIntervals};
+    context.optimalSchedule = scheduleCache_.schedule(key, model.getTotalShares(),
+        [&] { return scheduleShapeFor(model, numIntervals); });
     
     // Validate the schedule
     double total = 0.0;
@@ -150,9 +921,7 @@ void TradingEngine::calculateOptimalSchedule_(OrderExecutionContext& context) {
     
     // Handle rounding errors
     if (std::abs(total - context.order.totalShares) > 1.0) {
-        std::cerr << "Warning: Schedule total " << total 
-                  << " doesn't match order total " << context.order.totalShares 
-                  << std::endl;
+        AC_LOG_WARN("Schedule total {} doesn't match order total {}", total, context.order.totalShares);
         // Adjust last element to fix
         if (!context.optimalSchedule.empty()) {
             double diff = context.order.totalShares - total;
@@ -160,147 +929,579 @@ void TradingEngine::calculateOptimalSchedule_(OrderExecutionContext& context) {
         }
     }
     
-    std::cout << "Optimal schedule (Almgren-Chriss): ";
-    for (double shares : context.optimalSchedule) {
-        std::cout << static_cast<int>(shares) << " ";
-    }
-    std::cout << std::endl;
+    AC_LOG_DEBUG("Optimal schedule for {}: {} chunks", context.order.orderId, context.optimalSchedule.size());
+}
+
+
+std::chrono::steady_clock::duration TradingEngine::chunkInterval_(const OrderExecutionContext& context) {
+    // An equal share of the horizon per chunk, kept to the nanosecond
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(context.order.timeHorizon / context.optimalSchedule.size()));
 }
 
+void TradingEngine::anchorSchedule_(OrderExecutionContext& context, std::chrono::steady_clock::time_point now) {
+    if (context.optimalSchedule.empty()) {
+        return;
+    }
+    using Duration = std::chrono::steady_clock::duration;
+    context.scheduleAnchor = now - chunkInterval_(context) * static_cast<Duration::rep>(context.currentScheduleIndex);
+}
 
-void TradingEngine::scheduleNextChunk_(const std::string& orderId) {
-    auto it = activeOrders_.find(orderId);
-    if (it == activeOrders_.end() || it->second.status != OrderStatus::ACTIVE) {
+void TradingEngine::scheduleNextChunk_(OrderExecutionContext& context) {
+    if (context.status != OrderStatus::ACTIVE) {
         return;
     }
     
-    auto& context = it->second;
-    
     if (context.currentScheduleIndex >= context.optimalSchedule.size()) {
-        handleCompletedOrder_(orderId);
+        handleCompletedOrder_(context);
         return;
     }
     
-    double sharesToExecute = context.optimalSchedule[context.currentScheduleIndex];
-    
-    // If each chunk should take proportional time based on schedule
-    double totalTime = context.order.timeHorizon; 
-    size_t totalChunks = context.optimalSchedule.size(); 
-    double timePerChunk = totalTime / totalChunks; 
-    auto delay = std::chrono::milliseconds(static_cast<int>(timePerChunk * 1000));
-    
-    scheduler_.scheduleAfter(delay, [this, orderId, sharesToExecute]() {
-        this->executeTradeChunk_(orderId, sharesToExecute);
-    });
+    // Chunk k is due at its slot on the horizon, anchor + (k+1) T/N, however
+    // early ticks released the chunks before it, so the order still spans T.
+    // Under ChunkTrigger::MarketData that is only its deadline. An order
+    // behind its slots (a retried last chunk, an overloaded worker) waits one
+    // interval from now rather than firing at once.
+    using Duration = std::chrono::steady_clock::duration;
+    auto interval = chunkInterval_(context);
+    auto now = scheduler_.now();
+    auto deadline = context.scheduleAnchor + interval * static_cast<Duration::rep>(context.currentScheduleIndex + 1);
+    if (deadline <= now) {
+        deadline = now + interval;
+    }
+    context.releaseAt = chunkTrigger_ == ChunkTrigger::MarketData
+        ? deadline - std::chrono::duration_cast<Duration>(interval * releaseWindow_)
+        : std::chrono::steady_clock::time_point::max();
+
+    // Chunks on the same symbol stay ordered on one worker; other symbols run in parallel
+    OrderHandle handle = context.handle;
+    size_t chunkIndex = context.currentScheduleIndex;
+    context.pendingChunk = scheduler_.scheduleAt(deadline, [this, handle, chunkIndex]() {
+        this->executeTradeChunk_(handle, chunkIndex);
+    }, symbolAffinity_(context.symbolId));
     
     context.currentScheduleIndex++;
 }
 
-void TradingEngine::executeTradeChunk_(const std::string& orderId, double shares) {
-    std::lock_guard lock(orderMutex_);
-    
-    auto it = activeOrders_.find(orderId);
-    if (it == activeOrders_.end() || it->second.status != OrderStatus::ACTIVE) {
-        return;
+void TradingEngine::executeTradeChunk_(OrderHandle handle, size_t chunkIndex) {
+    activeOrders_.with(handle, [&](OrderExecutionContext& context) {
+        // Only the most recently scheduled chunk drives the chain; an older one can
+        // still be in flight if it was dispatched just before a pause/resume
+        bool latestChunk = chunkIndex + 1 == context.currentScheduleIndex;
+        if (context.status != OrderStatus::ACTIVE) {
+            // Dispatched before pause could cancel it: hand the chunk back for resume
+            if (context.status == OrderStatus::PAUSED && latestChunk) {
+                context.currentScheduleIndex = chunkIndex;
+            }
+            return;
+        }
+
+        // Venue reports may already have filled part of the order
+        double shares = std::min(context.optimalSchedule[chunkIndex],
+                                 context.order.totalShares - context.executedShares);
+        int64_t nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            scheduler_.now().time_since_epoch()).count();
+        std::optional<BookFill> taken = book_.take(context.symbolId, context.order.isBuy, shares, nowNs);
+        double executed = taken ? taken->shares : shares;
+
+        // What the book couldn't fill goes to the next chunk that hasn't run;
+        // past the last one, the rest is retried one interval later
+        double remainder = shares - executed;
+        bool carry = remainder > kMinCarryShares;
+        size_t carryTo = latestChunk ? context.currentScheduleIndex : context.currentScheduleIndex - 1;
+        bool retry = carry && latestChunk && carryTo >= context.optimalSchedule.size();
+        if (retry) {
+            context.optimalSchedule[chunkIndex] = remainder;
+            context.currentScheduleIndex = chunkIndex;
+        } else if (carry) {
+            context.optimalSchedule[chunkIndex] = executed;
+            context.optimalSchedule[carryTo] += remainder;
+        }
+        context.filledChunks = retry ? chunkIndex : chunkIndex + 1;
+
+        if (executed > 0.0) {
+            applyExecution_(context, executed, taken ? taken->averagePrice() : 0.0);
+        }
+        if (carry) {
+            journalReschedule_(context, chunkIndex);
+        }
+
+        // Schedule next chunk or complete order
+        if (context.executedShares >= context.order.totalShares) {
+            handleCompletedOrder_(context);
+        } else if (retry && scheduler_.now() >= context.scheduleAnchor +
+                       chunkInterval_(context) * (static_cast<int64_t>(context.optimalSchedule.size()) +
+                                                  kMaxOverrunIntervals)) {
+            handleExpiredOrder_(context);
+        } else if (latestChunk) {
+            scheduleNextChunk_(context);
+        }
+    });
+}
+
+void TradingEngine::onExecutionReport(const ExecutionReport& report) {
+    onExecutionReport(handleOf(report.orderId), report.executedShares, report.executionPrice);
+}
+
+void TradingEngine::onExecutionReport(OrderHandle handle, double shares, double price) {
+    if (!(shares > 0.0) || !(price > 0.0)) {
+        throw std::invalid_argument("Execution report needs positive shares and price");
     }
-    
-    auto& context = it->second;
-    
-    double executionPrice = context.model.simulatePriceStep(1.0); 
-    if (context.order.isBuy) {
-        executionPrice *= 1.001; 
-    } else {
-        executionPrice *= 0.999; 
+    bool known = activeOrders_.with(handle, [&](OrderExecutionContext& context) {
+        applyExecution_(context, shares, price);
+        if (!isTerminal_(context.status) && context.executedShares >= context.order.totalShares) {
+            scheduler_.cancel(context.pendingChunk);
+            handleCompletedOrder_(context);
+        }
+    });
+    if (!known) {
+        AC_LOG_WARN("Execution report for unknown order {}", orderIdOf(handle));
     }
-    
-    // Update execution state
-    context.executedShares += shares;
-    context.executionHistory.emplace_back(context.model.getElapsedTime(), executionPrice);
-    
-    // Recalculate running average price (VWAP)
-    double totalValue = context.averageExecutionPrice * (context.executedShares - shares);
-    totalValue += shares * executionPrice;
-    context.averageExecutionPrice = totalValue / context.executedShares;
+}
 
-    double progressPercent = (context.executedShares / context.order.totalShares) *100;
-    
-    emitExecution(orderId, context.order.symbol, shares, executionPrice, context.executedShares, context.order.totalShares);
+void TradingEngine::applyExecution_(OrderExecutionContext& context, double shares, double price) {
+    // 0 = no venue price: fill at the model's next price, crossing 10 bps.
+    // Venue fills leave the model's price path alone and carry engine time
+    double time = 0.0;
+    if (price <= 0.0) {
+        price = context.model.simulatePriceStep(1.0) * (context.order.isBuy ? 1.001 : 0.999);
+        ++context.modelSteps;
+        time = context.model.getElapsedTime();
+    } else if (context.startedAt) {
+        time = std::chrono::duration<double>(scheduler_.now() - *context.startedAt).count();
+    }
 
-    emitProgress(orderId, progressPercent);
+    FillRecord fill{time, price, shares};
+    context.applyFill(fill);
+    journalFill_(context, fill);
 
-    std::cout << "Executed " << static_cast<int>(shares) << " shares of " << context.order.symbol
-              << " @ $" << std::fixed << std::setprecision(2) << executionPrice 
-              << " for order " << orderId << std::endl;
-    
-    // Schedule next chunk or complete order
-    if (context.executedShares >= context.order.totalShares) {
-        handleCompletedOrder_(orderId);
-    } else {
-        scheduleNextChunk_(orderId);
-    }
+    emitExecution(context, shares, price);
+    emitProgress(context, (context.executedShares / context.order.totalShares) * 100);
+
+    AC_LOG_INFO("Executed {} shares of {} @ ${} for order {}",
+                static_cast<int>(shares), context.order.symbol, price, context.order.orderId);
 }
 
-void TradingEngine::updateModelWithExecution_(const std::string& orderId, double executedShares, double price) {
-    (void)orderId;
+void TradingEngine::updateModelWithExecution_(OrderHandle handle, double executedShares, double price) {
+    (void)handle;
     (void)executedShares;
     (void)price;
 }
 
-void TradingEngine::handleCompletedOrder_(const std::string& orderId) {
-    auto it = activeOrders_.find(orderId);
-    if (it != activeOrders_.end()) {
-        it->second.status = OrderStatus::COMPLETED;
+void TradingEngine::retireOrder_(OrderExecutionContext& context) {
+    // The handle itself is dropped from the symbol's list by the next recompute
+    symbolStates_[context.symbolId].liveOrders.fetch_sub(1, std::memory_order_relaxed);
+}
 
-        emitStatus(orderId, OrderStatus::COMPLETED);
-        
-        std::cout << "✅ Order COMPLETED: " << orderId 
-                  << " | Total shares: " << it->second.executedShares
-                  << " | Avg price: $" << std::fixed << std::setprecision(2) 
-                  << it->second.averageExecutionPrice << std::endl;
+void TradingEngine::handleCompletedOrder_(OrderExecutionContext& context) {
+    if (!isTerminal_(context.status)) {
+        retireOrder_(context);
+    }
+    context.status = OrderStatus::COMPLETED;
+    context.finishedAt = scheduler_.now();
+    journalStatus_(context);
+
+    emitStatus(context, OrderStatus::COMPLETED);
+    
+    AC_LOG_INFO("Order COMPLETED: {} | Total shares: {} | Avg price: ${}",
+                context.order.orderId, context.executedShares, context.averageExecutionPrice);
+}
+
+void TradingEngine::handleExpiredOrder_(OrderExecutionContext& context) {
+    retireOrder_(context);
+    context.status = OrderStatus::FAILED;
+    context.finishedAt = scheduler_.now();
+    journalStatus_(context);
+
+    emitStatus(context, OrderStatus::FAILED);
+
+    AC_LOG_WARN("Order FAILED: {} | book never filled the rest past the horizon | {} of {} shares",
+                context.order.orderId, context.executedShares, context.order.totalShares);
+}
+
+void TradingEngine::journalSubmit_(order_journal::batch& records, OrderExecutionContext& context) {
+    JournalSubmit submit = journalHeaderFor(context.order, context.jointSchedule, context.optimalSchedule.size());
+    const std::string& symbol = context.order.symbol;
+    records.add(JournalRecordType::Submit, context.handle, ++context.journalSequence,
+                {{&submit, sizeof(submit)},
+                 {symbol.data(), symbol.size()},
+                 {context.optimalSchedule.data(), context.optimalSchedule.size() * sizeof(double)}});
+}
+
+void TradingEngine::journalState_(order_journal::batch& records, const OrderExecutionContext& context) {
+    JournalOrderState state{};
+    state.order = journalHeaderFor(context.order, context.jointSchedule, context.optimalSchedule.size());
+    state.status = static_cast<int32_t>(context.status);
+    state.filledChunks = static_cast<uint32_t>(context.filledChunks);
+    state.executedShares = context.executedShares;
+    state.averageExecutionPrice = context.averageExecutionPrice;
+    state.historyLength = static_cast<uint32_t>(context.executionHistory.size());
+    state.modelSteps = context.modelSteps;
+    const std::string& symbol = context.order.symbol;
+    records.add(JournalRecordType::OrderState, context.handle, context.journalSequence,
+                {{&state, sizeof(state)},
+                 {symbol.data(), symbol.size()},
+                 {context.optimalSchedule.data(), context.optimalSchedule.size() * sizeof(double)},
+                 {context.executionHistory.data(), context.executionHistory.size() * sizeof(FillRecord)}});
+}
+
+void TradingEngine::journalStatus_(OrderExecutionContext& context) {
+    if (!journal_) {
+        return;
+    }
+    JournalStatus status{static_cast<int32_t>(context.status), 0};
+    order_journal::batch& records = scratchRecords();
+    records.add(JournalRecordType::Status, context.handle, ++context.journalSequence, &status, sizeof(status));
+    journal_->append(records);
+}
+
+void TradingEngine::journalFill_(OrderExecutionContext& context, const FillRecord& fill) {
+    if (!journal_) {
+        return;
+    }
+    JournalFill record{static_cast<uint32_t>(context.filledChunks), context.modelSteps, fill.time, fill.price,
+                       fill.shares};
+    order_journal::batch& records = scratchRecords();
+    records.add(JournalRecordType::Fill, context.handle, ++context.journalSequence, &record, sizeof(record));
+    journal_->append(records);
+}
+
+void TradingEngine::journalReschedule_(OrderExecutionContext& context, size_t from) {
+    if (!journal_) {
+        return;
+    }
+    JournalReschedule header{static_cast<uint32_t>(from), static_cast<uint32_t>(context.optimalSchedule.size() - from)};
+    order_journal::batch& records = scratchRecords();
+    records.add(JournalRecordType::Reschedule, context.handle, ++context.journalSequence,
+                {{&header, sizeof(header)},
+                 {context.optimalSchedule.data() + from, header.count * sizeof(double)}});
+    journal_->append(records);
+}
+
+void TradingEngine::checkpoint() {
+    if (!journal_) {
+        return;
+    }
+    std::lock_guard serial(checkpointMutex_);
+    uint64_t segment = 0;
+    {
+        std::unique_lock gate(submitGate_);
+        segment = journal_->beginSnapshot();
+    }
+    order_journal::batch state;
+    activeOrders_.forEach([&](OrderHandle, const OrderExecutionContext& context) {
+        journalState_(state, context);
+    });
+    journal_->writeSnapshot(segment, state);
+    AC_LOG_INFO("Checkpoint: {} orders, {} bytes, journal continues at segment {}",
+                state.records(), state.bytes(), segment);
+}
+
+void TradingEngine::recover_(const JournalConfig& config) {
+    auto started = std::chrono::steady_clock::now();
+
+    // 1. Replay into plain records; last writer per order wins
+    std::vector<RecoveredOrder> orders;
+    std::unordered_map<OrderHandle, size_t> index;
+    auto restore = [&](OrderHandle handle, const JournalSubmit& submit, payload_reader& payload) -> RecoveredOrder& {
+        auto [it, inserted] = index.try_emplace(handle, orders.size());
+        if (inserted) {
+            orders.emplace_back();
+        }
+        RecoveredOrder& recovered = orders[it->second];
+        recovered = RecoveredOrder{};
+        recovered.handle = handle;
+        recovered.order.symbol = payload.string(submit.symbolLength);
+        recovered.order.totalShares = submit.totalShares;
+        recovered.order.isBuy = submit.isBuy != 0;
+        recovered.order.initialPrice = submit.initialPrice;
+        recovered.order.timeHorizon = submit.timeHorizon;
+        recovered.order.riskAversion = submit.riskAversion;
+        recovered.order.numIntervals = submit.numIntervals;
+        recovered.jointSchedule = submit.jointSchedule != 0;
+        recovered.schedule = payload.doubles(submit.scheduleLength);
+        return recovered;
+    };
+
+    recovery_.replay = order_journal::replay(config.directory, [&](const JournalRecord& record) {
+        payload_reader payload(record);
+        if (record.type == JournalRecordType::OrderState) {
+            auto state = payload.read<JournalOrderState>();
+            RecoveredOrder& recovered = restore(record.handle, state.order, payload);
+            recovered.status = static_cast<OrderStatus>(state.status);
+            recovered.filledChunks = state.filledChunks;
+            recovered.modelSteps = state.modelSteps;
+            recovered.executedShares = state.executedShares;
+            recovered.averageExecutionPrice = state.averageExecutionPrice;
+            recovered.history.resize(state.historyLength);
+            payload.bytes(recovered.history.data(), state.historyLength * sizeof(FillRecord));
+            recovered.sequence = record.sequence;
+            return;
+        }
+
+        auto it = index.find(record.handle);
+        RecoveredOrder* known = it == index.end() ? nullptr : &orders[it->second];
+        if (known && record.sequence <= known->sequence) {
+            ++recovery_.skippedRecords; // already in the snapshot
+            return;
+        }
+        if (record.type == JournalRecordType::Submit) {
+            auto submit = payload.read<JournalSubmit>();
+            restore(record.handle, submit, payload).sequence = record.sequence;
+            return;
+        }
+        if (!known) {
+            ++recovery_.skippedRecords;
+            return;
+        }
+
+        known->sequence = record.sequence;
+        switch (record.type) {
+        case JournalRecordType::Status:
+            known->status = static_cast<OrderStatus>(payload.read<JournalStatus>().status);
+            break;
+        case JournalRecordType::Fill: {
+            auto fill = payload.read<JournalFill>();
+            known->fills.push_back({fill.time, fill.price, fill.shares});
+            known->filledChunks = fill.filledChunks;
+            known->modelSteps = fill.modelSteps;
+            break;
+        }
+        case JournalRecordType::Reschedule: {
+            auto header = payload.read<JournalReschedule>();
+            std::vector<double> tail = payload.doubles(header.count);
+            if (size_t{header.from} + header.count <= known->schedule.size()) {
+                std::copy(tail.begin(), tail.end(), known->schedule.begin() + header.from);
+            }
+            break;
+        }
+        default:
+            ++recovery_.skippedRecords;
+            break;
+        }
+    });
+
+    // 2. Contexts built the way submit builds them, in parallel blocks
+    const size_t count = orders.size();
+    std::vector<SymbolId> symbolIds(count);
+    for (size_t i = 0; i < count; ++i) {
+        symbolIds[i] = symbols_.intern(orders[i].order.symbol);
+    }
+    auto now = scheduler_.now();
+    std::vector<std::pair<OrderHandle, OrderExecutionContext>> entries(count);
+    forEachOrderBlock(count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            RecoveredOrder& recovered = orders[i];
+            OrderExecutionContext& context = entries[i].second;
+            entries[i].first = recovered.handle;
+            buildOrderContext_(context, recovered.handle, symbolIds[i], recovered.order, &recovered.schedule);
+            context.jointSchedule = recovered.jointSchedule;
+            context.status = recovered.status;
+            context.executedShares = recovered.executedShares;
+            context.averageExecutionPrice = recovered.averageExecutionPrice;
+            context.executionHistory = std::move(recovered.history);
+            for (const FillRecord& fill : recovered.fills) {
+                context.applyFill(fill);
+            }
+            context.filledChunks = recovered.filledChunks;
+            context.currentScheduleIndex = std::min(context.filledChunks, context.optimalSchedule.size());
+            context.journalSequence = recovered.sequence;
+            // Each simulated fill moved the model's price path one step; catching
+            // up keeps a seeded run on the path it would have taken without the restart
+            for (uint32_t step = 0; step < recovered.modelSteps; ++step) {
+                context.model.simulatePriceStep(1.0);
+            }
+            context.modelSteps = recovered.modelSteps;
+            if (context.status == OrderStatus::ACTIVE || context.status == OrderStatus::PAUSED) {
+                context.startedAt = now; // the old clock's times mean nothing to this one
+                anchorSchedule_(context, now);
+            }
+        }
+    });
+
+    // 3. Into the table, then queue the next chunk of every active order
+    std::vector<std::pair<SymbolId, OrderHandle>> live;
+    std::vector<OrderHandle> active;
+    OrderHandle last = kInvalidOrderHandle;
+    for (const auto& [handle, context] : entries) {
+        if (!isTerminal_(context.status)) {
+            live.emplace_back(context.symbolId, handle);
+        }
+        if (context.status == OrderStatus::ACTIVE) {
+            active.push_back(handle);
+        }
+        last = std::max(last, handle);
+    }
+    recovery_.orders = count;
+    activeOrders_.reserveThrough(last);
+    activeOrders_.insertBatch(std::move(entries));
+    registerWithSymbols_(live);
+
+    journal_ = std::make_unique<order_journal>(config);
+    journal_->setSnapshotCallback([this] { checkpoint(); });
+
+    activeOrders_.withEach(active, [&](OrderHandle, OrderExecutionContext& context) {
+        scheduleNextChunk_(context);
+        ++recovery_.rescheduled;
+    });
+
+    recovery_.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started);
+    if (count > 0) {
+        AC_LOG_INFO("Recovered {} orders ({} rescheduled) from {} snapshot and {} journal records in {} us",
+                    count, recovery_.rescheduled, recovery_.replay.snapshotRecords,
+                    recovery_.replay.segmentRecords, recovery_.elapsed.count());
     }
 }
 
+void TradingEngine::deliverEvents_(const EngineEvent* events, size_t count) {
+    auto deliver = [&]() {
+        for (size_t i = 0; i < count; ++i) {
+            const EngineEvent& event = events[i];
+            std::string orderId = orderIdOf(event.order);
+            auto started = std::chrono::steady_clock::now();
+            switch (event.type) {
+                case EngineEventType::Execution:
+                    if (executionCallback_) {
+                        executionCallback_(orderId, symbols_.name(event.symbol), event.shares, event.price,
+                                           event.totalExecuted, event.totalShares);
+                    }
+                    break;
+                case EngineEventType::Status:
+                    if (statusCallback_) {
+                        statusCallback_(orderId, event.status);
+                    }
+                    break;
+                case EngineEventType::Progress:
+                    if (progressCallback_) {
+                        progressCallback_(orderId, event.progressPercent);
+                    }
+                    break;
+            }
+            callbackTime_.record(std::chrono::steady_clock::now() - started);
+        }
+    };
+
+    if (callbackScope_) {
+        callbackScope_(deliver);
+    } else {
+        deliver();
+    }
+}
+
+EngineStats TradingEngine::stats() const {
+    EngineStats stats;
+    stats.dispatchLag = scheduler_.dispatchLag();
+    stats.taskRunTime = scheduler_.runTime();
+    stats.lockWait = lockWait_.summary();
+    stats.lockAcquisitions = activeOrders_.lockAcquisitions();
+    stats.callbackTime = callbackTime_.summary();
+    stats.dispatch = dispatcher_.stats();
+    stats.scheduleCache = scheduleCache_.stats();
+    if (journal_) {
+        stats.journal = journal_->stats();
+    }
+    stats.recovery = recovery_;
+    stats.book = book_.stats();
+    stats.pendingTasks = scheduler_.pendingTasks();
+    stats.scheduleAdjustments = scheduleAdjustments_.load(std::memory_order_relaxed);
+    stats.releasedChunks = releasedChunks_.load(std::memory_order_relaxed);
+    return stats;
+}
+
 // Simple implementations for demo purposes
 std::vector<TradingEngine::Order> TradingEngine::getActiveOrder() const {
-    std::lock_guard lock(orderMutex_);
     std::vector<Order> orders;
-    for (const auto& [id, context] : activeOrders_) {
+    activeOrders_.forEach([&](OrderHandle, const OrderExecutionContext& context) {
         if (context.status == OrderStatus::ACTIVE || context.status == OrderStatus::PENDING) {
             orders.push_back(context.order);
         }
-    }
+    });
     return orders;
 }
 
 ExecutionMetrics TradingEngine::getOrderMetrics(const std::string& orderId) const {
-    std::lock_guard lock(orderMutex_);
-    ExecutionMetrics metrics;
+    return getOrderMetrics(handleOf(orderId));
+}
+
+ExecutionMetrics TradingEngine::getOrderMetrics(OrderHandle handle) const {
+    ExecutionMetrics metrics{};
     
-    auto it = activeOrders_.find(orderId);
-    if (it != activeOrders_.end()) {
-        const auto& context = it->second;
+    activeOrders_.with(handle, [&](const OrderExecutionContext& context) {
         metrics.totalShares = context.order.totalShares;
         metrics.executedShares = context.executedShares;
         metrics.averageExecutionPrice = context.averageExecutionPrice;
         // Simplified calculations for demo
         metrics.implementationShortfall = (context.averageExecutionPrice - context.order.initialPrice) * context.executedShares;
-    }
+        if (context.startedAt) {
+            auto end = context.finishedAt ? *context.finishedAt : scheduler_.now();
+            metrics.executionTime = std::chrono::duration_cast<std::chrono::milliseconds>(end - *context.startedAt);
+        }
+    });
     
     return metrics;
 }
 
 std::vector<double> TradingEngine::getRemainingSchedule(const std::string& orderId) const {
-    std::lock_guard lock(orderMutex_);
-    
-    auto it = activeOrders_.find(orderId);
-    if (it != activeOrders_.end()) {
-        const auto& context = it->second;
+    return getRemainingSchedule(handleOf(orderId));
+}
+
+std::vector<double> TradingEngine::getRemainingSchedule(OrderHandle handle) const {
+    std::vector<double> remaining;
+    activeOrders_.with(handle, [&](const OrderExecutionContext& context) {
         if (context.currentScheduleIndex < context.optimalSchedule.size()) {
-            return std::vector<double>(
-                context.optimalSchedule.begin() + context.currentScheduleIndex,
-                context.optimalSchedule.end()
-            );
+            remaining.assign(context.optimalSchedule.begin() + context.currentScheduleIndex,
+                             context.optimalSchedule.end());
         }
+    });
+    return remaining;
+}
+
+std::vector<FillRecord> TradingEngine::getExecutionHistory(const std::string& orderId) const {
+    return getExecutionHistory(handleOf(orderId));
+}
+
+std::vector<FillRecord> TradingEngine::getExecutionHistory(OrderHandle handle) const {
+    std::vector<FillRecord> history;
+    activeOrders_.with(handle, [&](const OrderExecutionContext& context) {
+        history = context.executionHistory;
+    });
+    return history;
+}
+
+std::vector<OrderMetricsRow> TradingEngine::getAllOrderMetrics() const {
+    std::vector<OrderMetricsRow> rows;
+    activeOrders_.forEach([&](OrderHandle handle, const OrderExecutionContext& context) {
+        OrderMetricsRow row{};
+        row.handle = handle;
+        row.status = static_cast<int32_t>(context.status);
+        row.totalShares = context.order.totalShares;
+        row.executedShares = context.executedShares;
+        row.averageExecutionPrice = context.averageExecutionPrice;
+        row.implementationShortfall = (context.averageExecutionPrice - context.order.initialPrice) * context.executedShares;
+        row.progressPercent = context.order.totalShares > 0
+                                  ? context.executedShares / context.order.totalShares * 100.0 : 0.0;
+        rows.push_back(row);
+    });
+    std::sort(rows.begin(), rows.end(),
+              [](const OrderMetricsRow& a, const OrderMetricsRow& b) { return a.handle < b.handle; });
+    return rows;
+}
+
+MonteCarloResult TradingEngine::simulateExecutionCost(const std::string& orderId, size_t paths, uint64_t seed) const {
+    AlmgrenChrissModel model;
+    std::vector<double> schedule;
+    bool isBuy = false;
+    bool found = activeOrders_.with(handleOf(orderId), [&](const OrderExecutionContext& context) {
+        model = context.model;
+        schedule = context.optimalSchedule;
+        isBuy = context.order.isBuy;
+    });
+    if (!found) {
+        throw std::invalid_argument("Order not found: " + orderId);
     }
-    return {};
-}
\ No newline at end of file
+
+    // Paths run outside the order lock
+    MonteCarloSimulator simulator;
+    return simulator.run(model, schedule, paths, isBuy, seed);
+}
@@ -0,0 +1,87 @@
+#include "trajectory_kernel.hpp"
+
+namespace trajectory {
+namespace {
+
+// The fixed-size path is checked at compile time: a TWAP splits evenly, and
+// a hyperbolic plan front-loads and still sums to the order
+constexpr auto kTwapCheck = fixedSchedule<Shape::Linear, 4>(Params::make(0.0, 60.0, 400.0));
+static_assert(kTwapCheck[0] == 100.0 && kTwapCheck[3] == 100.0);
+constexpr auto kFrontLoadCheck = fixedSchedule<Shape::Hyperbolic, 3>(Params::make(0.01, 300.0, 900.0));
+static_assert(kFrontLoadCheck[0] > kFrontLoadCheck[1] && kFrontLoadCheck[1] > kFrontLoadCheck[2]);
+static_assert(kFrontLoadCheck[0] + kFrontLoadCheck[1] + kFrontLoadCheck[2] > 900.0 - 1e-9 &&
+              kFrontLoadCheck[0] + kFrontLoadCheck[1] + kFrontLoadCheck[2] < 900.0 + 1e-9);
+
+template <Shape S>
+void remainingLoop(const Params& p, const double* times, double* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = remainingAt<S>(p, times[i]);
+    }
+}
+
+template <Shape S>
+void rateLoop(const Params& p, const double* times, double* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = rateAt<S>(p, times[i]);
+    }
+}
+
+template <Shape S>
+void scheduleLoop(const Params& p, int intervals, double* out) {
+    int n = intervals; // int index: int -> double converts in SIMD, size_t doesn't
+    double step = p.timeHorizon / n;
+
+    // Pass 1: shares left at the end of each interval (the last is exactly 0)
+    for (int i = 0; i + 1 < n; ++i) {
+        out[i] = remainingAt<S>(p, (i + 1) * step);
+    }
+    out[n - 1] = 0.0;
+
+    // Pass 2: chunk i = x(t_i) - x(t_{i+1}), walking backwards so each
+    // boundary is read before it is overwritten
+    for (int i = n - 1; i > 0; --i) {
+        out[i] = detail::atLeastZero(out[i - 1] - out[i]);
+    }
+    out[0] = detail::atLeastZero(p.totalShares - out[0]);
+}
+
+} // namespace
+
+void remainingShares(const Params& params, const double* times, double* out, size_t count) {
+    if (params.shape == Shape::Linear) {
+        remainingLoop<Shape::Linear>(params, times, out, count);
+    } else {
+        remainingLoop<Shape::Hyperbolic>(params, times, out, count);
+    }
+}
+
+void tradingRate(const Params& params, const double* times, double* out, size_t count) {
+    if (params.shape == Shape::Linear) {
+        rateLoop<Shape::Linear>(params, times, out, count);
+    } else {
+        rateLoop<Shape::Hyperbolic>(params, times, out, count);
+    }
+}
+
+void schedule(const Params& params, int intervals, double* out) {
+    if (intervals <= 0) {
+        return;
+    }
+    if (params.shape == Shape::Linear) {
+        scheduleLoop<Shape::Linear>(params, intervals, out);
+    } else {
+        scheduleLoop<Shape::Hyperbolic>(params, intervals, out);
+    }
+}
+
+void scheduleBatch(const TrajectoryBatch& batch, int intervals, double* out) {
+    if (intervals <= 0) {
+        return;
+    }
+    for (size_t order = 0; order < batch.size(); ++order) {
+        Params params = Params::make(batch.kappa[order], batch.timeHorizon[order], batch.totalShares[order]);
+        schedule(params, intervals, out + order * static_cast<size_t>(intervals));
+    }
+}
+
+} // namespace trajectory
@@ -0,0 +1,230 @@
+#include "worker_pool.hpp"
+
+worker_pool::worker_pool(size_t workers, Runner runner)
+    : runner_(std::move(runner)) {
+    workers_.reserve(workers);
+    for (size_t i = 0; i < workers; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+}
+
+worker_pool::~worker_pool() {
+    stop();
+}
+
+void worker_pool::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        workers_[i]->thread = std::thread(&worker_pool::workerLoop_, this, i);
+        thread_tuning::setName(workers_[i]->thread.native_handle(), "ac-worker-" + std::to_string(i));
+    }
+}
+
+std::vector<NamedThread> worker_pool::threads() const {
+    std::vector<NamedThread> threads;
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        std::thread& thread = workers_[i]->thread;
+        if (thread.joinable()) {
+            threads.push_back({"ac-worker-" + std::to_string(i), thread.native_handle()});
+        }
+    }
+    return threads;
+}
+
+void worker_pool::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    for (auto& worker : workers_) {
+        {
+            std::lock_guard lock(worker->mutex);
+        }
+        worker->condition.notify_all();
+    }
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+void worker_pool::submit(ScheduledTask task) {
+    size_t index;
+    if (task.affinity != 0) {
+        index = static_cast<size_t>(task.affinity % workers_.size());
+    } else {
+        index = nextShared_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+    }
+
+    Worker& worker = *workers_[index];
+    bool busy;
+    {
+        std::lock_guard lock(worker.mutex);
+        if (task.affinity != 0) {
+            KeyQueue& queue = worker.keys[task.affinity];
+            queue.tasks.push_back(std::move(task));
+            ++worker.keyTasks;
+            if (!queue.claimed && queue.tasks.size() == 1) {
+                worker.ready.push_back(queue.tasks.front().affinity);
+            }
+        } else {
+            worker.shared.push_back(std::move(task));
+        }
+        // Work is waiting behind whatever the owner is running
+        busy = !worker.sleeping && (!worker.ready.empty() || !worker.shared.empty());
+    }
+    worker.condition.notify_one();
+    if (busy) {
+        wakeIdle_(index);
+    }
+}
+
+size_t worker_pool::queued() const {
+    size_t total = 0;
+    for (const auto& worker : workers_) {
+        std::lock_guard lock(worker->mutex);
+        total += worker->keyTasks + worker->shared.size();
+    }
+    return total;
+}
+
+bool worker_pool::popShared_(Worker& worker, ScheduledTask& out, bool back) {
+    std::unique_lock lock(worker.mutex, std::defer_lock);
+    if (back) {
+        if (!lock.try_lock()) {
+            return false;
+        }
+    } else {
+        lock.lock();
+    }
+    if (worker.shared.empty()) {
+        return false;
+    }
+    if (back) {
+        out = std::move(worker.shared.back());
+        worker.shared.pop_back();
+    } else {
+        out = std::move(worker.shared.front());
+        worker.shared.pop_front();
+    }
+    return true;
+}
+
+bool worker_pool::claimKey_(Worker& home, uint64_t& key, bool back) {
+    std::unique_lock lock(home.mutex, std::defer_lock);
+    if (back) {
+        if (!lock.try_lock()) {
+            return false;
+        }
+    } else {
+        lock.lock();
+    }
+    if (home.ready.empty()) {
+        return false;
+    }
+    if (back) {
+        key = home.ready.back();
+        home.ready.pop_back();
+    } else {
+        key = home.ready.front();
+        home.ready.pop_front();
+    }
+    home.keys[key].claimed = true;
+    return true;
+}
+
+void worker_pool::drainKey_(Worker& home, uint64_t key) {
+    bool requeued = false;
+    for (size_t ran = 0;; ++ran) {
+        ScheduledTask task;
+        {
+            std::lock_guard lock(home.mutex);
+            auto it = home.keys.find(key);
+            KeyQueue& queue = it->second;
+            if (queue.tasks.empty()) {
+                home.keys.erase(it);
+                break;
+            }
+            if (ran == kKeyBatch || !running_) {
+                queue.claimed = false;
+                home.ready.push_back(key);
+                requeued = true;
+                break;
+            }
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            --home.keyTasks;
+        }
+        runner_(task);
+    }
+    if (requeued && running_) {
+        home.condition.notify_one();
+        wakeIdle_(static_cast<size_t>(key % workers_.size()));
+    }
+}
+
+bool worker_pool::steal_(size_t thief) {
+    // Unpinned tasks come from the victim's back; keys from the back of its
+    // ready list (the ones its owner would get to last), drained whole
+    for (size_t offset = 1; offset < workers_.size(); ++offset) {
+        Worker& victim = *workers_[(thief + offset) % workers_.size()];
+        ScheduledTask task;
+        if (popShared_(victim, task, true)) {
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            runner_(task);
+            return true;
+        }
+        uint64_t key;
+        if (claimKey_(victim, key, true)) {
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            drainKey_(victim, key);
+            return true;
+        }
+    }
+    return false;
+}
+
+void worker_pool::wakeIdle_(size_t except) {
+    for (size_t offset = 1; offset < workers_.size(); ++offset) {
+        Worker& worker = *workers_[(except + offset) % workers_.size()];
+        std::unique_lock lock(worker.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || !worker.sleeping || worker.woken) {
+            continue;
+        }
+        worker.woken = true;
+        lock.unlock();
+        worker.condition.notify_one();
+        return;
+    }
+}
+
+void worker_pool::workerLoop_(size_t index) {
+    Worker& self = *workers_[index];
+    ScheduledTask task;
+
+    while (running_) {
+        uint64_t key;
+        if (claimKey_(self, key, false)) {
+            drainKey_(self, key);
+            continue;
+        }
+        if (popShared_(self, task, false)) {
+            runner_(task);
+            task = ScheduledTask{};
+            continue;
+        }
+        if (steal_(index)) {
+            continue;
+        }
+
+        std::unique_lock lock(self.mutex);
+        self.sleeping = true;
+        self.condition.wait(lock, [&]() {
+            return !self.ready.empty() || !self.shared.empty() || self.woken || !running_;
+        });
+        self.sleeping = false;
+        self.woken = false;
+    }
+}
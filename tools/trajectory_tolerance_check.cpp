@@ -0,0 +1,131 @@
+// Holds the trajectory kernel to the bound documented in trajectory_kernel.hpp:
+// against the sinh/cosh formulas, shares and chunk sizes within
+// kTrajectoryTolerance * X, rates within kTrajectoryTolerance relative. Sweeps
+// κT from 1e-12 (Linear) to 700, through the point evaluators, the array
+// kernels, schedule() and scheduleBatch(). Registered with CTest; exits 1 and
+// prints the worst case when the bound is exceeded.
+//
+// usage: trajectory_tolerance_check
+#include "trajectory_kernel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+using trajectory::kTrajectoryTolerance;
+
+// The scalar path the kernel replaced
+double remainingReference(double kappa, double horizon, double shares, double t) {
+    if (kappa * horizon < trajectory::kLinearKappaT) {
+        return shares * (1.0 - t / horizon);
+    }
+    return shares * std::sinh(kappa * (horizon - t)) / std::sinh(kappa * horizon);
+}
+
+double rateReference(double kappa, double horizon, double shares, double t) {
+    if (kappa * horizon < trajectory::kLinearKappaT) {
+        return shares / horizon;
+    }
+    return shares * kappa * std::cosh(kappa * (horizon - t)) / std::sinh(kappa * horizon);
+}
+
+struct Worst {
+    double error{0.0};
+    std::string where;
+
+    void record(double value, const std::string& what, double kappaT, double t) {
+        if (value > error) {
+            error = value;
+            where = what + " at kappaT=" + std::to_string(kappaT) + " t/T=" + std::to_string(t);
+        }
+    }
+};
+
+} // namespace
+
+int main() {
+    constexpr double kShares = 250000.0;
+    constexpr int kPoints = 257;
+    const double horizons[] = {60.0, 3600.0, 23400.0};
+    const int intervalCounts[] = {1, 10, 100, 390};
+
+    Worst shares;
+    Worst rates;
+    trajectory::TrajectoryBatch batch;
+    for (double horizon : horizons) {
+        for (double kappaT = 1e-12; kappaT <= 700.0; kappaT *= 1.5) {
+            const double kappa = kappaT / horizon;
+            const auto params = trajectory::Params::make(kappa, horizon, kShares);
+            batch.add(kappa, horizon, kShares);
+
+            std::vector<double> times(kPoints);
+            for (int i = 0; i < kPoints; ++i) {
+                times[i] = horizon * i / (kPoints - 1);
+            }
+            std::vector<double> remaining(kPoints);
+            std::vector<double> rate(kPoints);
+            trajectory::remainingShares(params, times.data(), remaining.data(), kPoints);
+            trajectory::tradingRate(params, times.data(), rate.data(), kPoints);
+
+            const bool linear = params.shape == trajectory::Shape::Linear;
+            for (int i = 0; i < kPoints; ++i) {
+                const double t = times[i];
+                const double x = remainingReference(kappa, horizon, kShares, t);
+                const double v = rateReference(kappa, horizon, kShares, t);
+                const double point = linear ? trajectory::remainingAt<trajectory::Shape::Linear>(params, t)
+                                            : trajectory::remainingAt<trajectory::Shape::Hyperbolic>(params, t);
+                const double pointRate = linear ? trajectory::rateAt<trajectory::Shape::Linear>(params, t)
+                                                : trajectory::rateAt<trajectory::Shape::Hyperbolic>(params, t);
+                shares.record(std::abs(remaining[i] - x) / kShares, "remainingShares", kappaT, t / horizon);
+                shares.record(std::abs(point - x) / kShares, "remainingAt", kappaT, t / horizon);
+                // Deep in the tail the rate underflows toward zero in both paths
+                if (v > 1e-290) {
+                    rates.record(std::abs(rate[i] - v) / v, "tradingRate", kappaT, t / horizon);
+                    rates.record(std::abs(pointRate - v) / v, "rateAt", kappaT, t / horizon);
+                }
+            }
+
+            for (int intervals : intervalCounts) {
+                std::vector<double> chunks(intervals);
+                trajectory::schedule(params, intervals, chunks.data());
+                for (int k = 0; k < intervals; ++k) {
+                    const double begin = horizon * k / intervals;
+                    const double end = horizon * (k + 1) / intervals;
+                    const double expected = remainingReference(kappa, horizon, kShares, begin) -
+                                            remainingReference(kappa, horizon, kShares, end);
+                    shares.record(std::abs(chunks[k] - expected) / kShares,
+                                  "schedule/" + std::to_string(intervals), kappaT, begin / horizon);
+                }
+            }
+        }
+    }
+
+    // The batch kernel must agree with schedule() order by order
+    for (int intervals : intervalCounts) {
+        std::vector<double> all(batch.size() * intervals);
+        trajectory::scheduleBatch(batch, intervals, all.data());
+        std::vector<double> one(intervals);
+        for (size_t order = 0; order < batch.size(); ++order) {
+            const auto params = trajectory::Params::make(batch.kappa[order], batch.timeHorizon[order],
+                                                         batch.totalShares[order]);
+            trajectory::schedule(params, intervals, one.data());
+            for (int k = 0; k < intervals; ++k) {
+                shares.record(std::abs(all[order * intervals + k] - one[k]) / kShares,
+                              "scheduleBatch/" + std::to_string(intervals),
+                              batch.kappa[order] * batch.timeHorizon[order], static_cast<double>(k) / intervals);
+            }
+        }
+    }
+
+    std::printf("shares: max error %.3g of X (%s)\n", shares.error, shares.where.c_str());
+    std::printf("rates:  max error %.3g relative (%s)\n", rates.error, rates.where.c_str());
+    std::printf("bound:  %.3g\n", kTrajectoryTolerance);
+    if (shares.error > kTrajectoryTolerance || rates.error > kTrajectoryTolerance) {
+        std::printf("FAILED: trajectory kernel exceeds kTrajectoryTolerance\n");
+        return 1;
+    }
+    return 0;
+}